@@ -86,6 +86,8 @@ enum options_client
   OPT_SLAP_COMMIT,
   OPT_SLAP_DETACH,
   OPT_SLAP_NO_DROP,
+  OPT_SLAP_PIPELINE,
+  OPT_SLAP_RESET_CONNECTION,
   OPT_MYSQL_REPLACE_INTO, OPT_BASE64_OUTPUT_MODE, OPT_SERVER_ID,
   OPT_FIX_TABLE_NAMES, OPT_FIX_DB_NAMES, OPT_SSL_VERIFY_SERVER_CERT,
   OPT_AUTO_VERTICAL_OUTPUT,
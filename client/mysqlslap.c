@@ -130,6 +130,7 @@ const char *create_schema_string= "mysqlslap";
 static my_bool opt_preserve= TRUE, opt_no_drop= FALSE;
 static my_bool debug_info_flag= 0, debug_check_flag= 0;
 static my_bool opt_only_print= FALSE;
+static my_bool opt_reset_connection= FALSE;
 static my_bool opt_compress= FALSE, tty_password= FALSE,
                opt_silent= FALSE,
                auto_generate_sql_autoincrement= FALSE,
@@ -144,6 +145,7 @@ static unsigned long connect_flags= CLIENT_MULTI_RESULTS |
 static int verbose;
 static uint commit_rate;
 static uint detach_rate;
+static uint pipeline_depth;
 const char *num_int_cols_opt;
 const char *num_char_cols_opt;
 
@@ -261,6 +263,8 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr);
 static int run_statements(MYSQL *mysql, statement *stmt);
 int slap_connect(MYSQL *mysql);
 static int run_query(MYSQL *mysql, const char *query, size_t len);
+static int send_query(MYSQL *mysql, const char *query, size_t len);
+static void read_results(MYSQL *mysql, uint *pending, ulonglong *counter);
 
 static const char ALPHANUMERICS[]=
   "0123456789ABCDEFGHIJKLMNOPQRSTWXYZabcdefghijklmnopqrstuvwxyz";
@@ -655,6 +659,10 @@ static struct my_option my_long_options[] =
   {"pipe", 'W', "Use named pipes to connect to server.", 0, 0, 0, GET_NO_ARG,
     NO_ARG, 0, 0, 0, 0, 0, 0},
 #endif
+  {"pipeline", OPT_SLAP_PIPELINE,
+    "Number of queries a client sends before it reads their results.",
+    &pipeline_depth, &pipeline_depth, 0, GET_UINT, REQUIRED_ARG,
+    1, 1, 0, 0, 0, 0},
   {"plugin_dir", OPT_PLUGIN_DIR, "Directory for client-side plugins.",
    &opt_plugin_dir, &opt_plugin_dir, 0,
    GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
@@ -683,6 +691,11 @@ static struct my_option my_long_options[] =
   {"query", 'q', "Query to run or file containing query to run.",
     &user_supplied_query, &user_supplied_query,
     0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"reset-connection", OPT_SLAP_RESET_CONNECTION,
+    "With --detach, reset connections (COM_RESET_CONNECTION) instead of "
+    "closing and reopening them.",
+    &opt_reset_connection, &opt_reset_connection, 0, GET_BOOL, NO_ARG,
+    0, 0, 0, 0, 0, 0},
   {"silent", 's', "Run program in silent mode - no output.",
     &opt_silent, &opt_silent, 0, GET_BOOL,  NO_ARG,
     0, 0, 0, 0, 0, 0},
@@ -1543,6 +1556,57 @@ static int run_query(MYSQL *mysql, const char *query, size_t len)
 }
 
 
+/*
+  Send a query of the test without waiting for its result when
+  --pipeline is used. The results are read by read_results().
+*/
+
+static int send_query(MYSQL *mysql, const char *query, size_t len)
+{
+  if (pipeline_depth <= 1 || opt_only_print)
+    return run_query(mysql, query, len);
+
+  if (verbose >= 3)
+    printf("%.*s;\n", (int)len, query);
+
+  return mysql_send_query(mysql, query, (ulong)len);
+}
+
+
+static void read_results(MYSQL *mysql, uint *pending, ulonglong *counter)
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+
+  for (; *pending; (*pending)--)
+  {
+    if (pipeline_depth > 1 && !opt_only_print &&
+        mysql_read_query_result(mysql))
+    {
+      fprintf(stderr,"%s: Cannot read query result ERROR : %s\n",
+              my_progname, mysql_error(mysql));
+      exit(0);
+    }
+
+    do
+    {
+      if (mysql_field_count(mysql))
+      {
+        if (!(result= mysql_store_result(mysql)))
+          fprintf(stderr, "%s: Error when storing result: %d %s\n",
+                  my_progname, mysql_errno(mysql), mysql_error(mysql));
+        else
+        {
+          while ((row= mysql_fetch_row(result)))
+            (*counter)++;
+          mysql_free_result(result);
+        }
+      }
+    } while(mysql_next_result(mysql) == 0);
+  }
+}
+
+
 static int
 generate_primary_key_list(MYSQL *mysql, option_string *engine_stmt)
 {
@@ -1835,9 +1899,8 @@ pthread_handler_t run_task(void *p)
   ulonglong counter= 0, queries;
   ulonglong detach_counter;
   unsigned int commit_counter;
+  uint pending= 0;
   MYSQL *mysql;
-  MYSQL_RES *result;
-  MYSQL_ROW row;
   statement *ptr;
   thread_context *con= (thread_context *)p;
 
@@ -1890,16 +1953,29 @@ pthread_handler_t run_task(void *p)
     {
       if (!opt_only_print && detach_rate && !(detach_counter % detach_rate))
       {
-        mysql_close(mysql);
-
-        if (!(mysql= mysql_init(NULL)))
+        read_results(mysql, &pending, &counter);
+        if (opt_reset_connection)
         {
-          fprintf(stderr,"%s: mysql_init() failed ERROR : %s\n",
-                  my_progname, mysql_error(mysql));
-          exit(0);
+          if (mysql_reset_connection(mysql))
+          {
+            fprintf(stderr,"%s: Cannot reset connection ERROR : %s\n",
+                    my_progname, mysql_error(mysql));
+            exit(0);
+          }
+        }
+        else
+        {
+          mysql_close(mysql);
+
+          if (!(mysql= mysql_init(NULL)))
+          {
+            fprintf(stderr,"%s: mysql_init() failed ERROR : %s\n",
+                    my_progname, mysql_error(mysql));
+            exit(0);
+          }
+          if (slap_connect(mysql))
+            goto end;
         }
-        if (slap_connect(mysql))
-          goto end;
       }
 
       /* 
@@ -1931,43 +2007,33 @@ pthread_handler_t run_task(void *p)
           length= snprintf(buffer, HUGE_STRING_LENGTH, "%.*s '%s'", 
                            (int)ptr->length, ptr->string, key);
 
-          if (run_query(mysql, buffer, length))
+          if (send_query(mysql, buffer, length))
           {
             fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
                     my_progname, (uint)length, buffer, mysql_error(mysql));
             exit(0);
           }
+          pending++;
         }
       }
       else
       {
-        if (run_query(mysql, ptr->string, ptr->length))
+        if (send_query(mysql, ptr->string, ptr->length))
         {
           fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
                   my_progname, (uint)ptr->length, ptr->string, mysql_error(mysql));
           exit(0);
         }
+        pending++;
       }
 
-      do
-      {
-        if (mysql_field_count(mysql))
-        {
-          if (!(result= mysql_store_result(mysql)))
-            fprintf(stderr, "%s: Error when storing result: %d %s\n",
-                    my_progname, mysql_errno(mysql), mysql_error(mysql));
-          else
-          {
-            while ((row= mysql_fetch_row(result)))
-              counter++;
-            mysql_free_result(result);
-          }
-        }
-      } while(mysql_next_result(mysql) == 0);
+      if (pending == pipeline_depth)
+        read_results(mysql, &pending, &counter);
       queries++;
 
       if (commit_rate && (++commit_counter == commit_rate))
       {
+        read_results(mysql, &pending, &counter);
         commit_counter= 0;
         run_query(mysql, "COMMIT", strlen("COMMIT"));
       }
@@ -1980,6 +2046,7 @@ pthread_handler_t run_task(void *p)
       goto limit_not_met;
 
 end:
+  read_results(mysql, &pending, &counter);
   if (commit_rate)
     run_query(mysql, "COMMIT", strlen("COMMIT"));
 
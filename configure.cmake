@@ -394,6 +394,7 @@ CHECK_FUNCTION_EXISTS (readlink HAVE_READLINK)
 CHECK_FUNCTION_EXISTS (realpath HAVE_REALPATH)
 CHECK_FUNCTION_EXISTS (rename HAVE_RENAME)
 CHECK_FUNCTION_EXISTS (rwlock_init HAVE_RWLOCK_INIT)
+CHECK_FUNCTION_EXISTS (sched_getcpu HAVE_SCHED_GETCPU)
 CHECK_FUNCTION_EXISTS (sched_yield HAVE_SCHED_YIELD)
 CHECK_FUNCTION_EXISTS (setenv HAVE_SETENV)
 CHECK_FUNCTION_EXISTS (setlocale HAVE_SETLOCALE)
@@ -31,7 +31,6 @@ extern "C" {
 #include <thr_lock.h>
 
 #include "my_compare.h"
-#include "my_tree.h"
 
 	/* defines used by heap-funktions */
 
@@ -109,6 +108,38 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For referense */
 
+typedef struct st_hp_blob_desc		/* BLOB column of a table record */
+{
+  uint offset;				/* Offset of the column in record */
+  uint packlength;			/* Bytes used to store the length */
+} HP_BLOB_DESC;
+
+struct st_hp_btree_node;
+
+typedef struct st_hp_btree		/* B+tree of a BTREE key */
+{
+  struct st_hp_btree_node *root;
+  struct st_hp_btree_node *first, *last;	/* Leftmost and rightmost leaf */
+  struct st_hp_btree_node *free_nodes;	/* Nodes reserved for splits */
+  size_t allocated;			/* Memory used by the nodes */
+  ulong records;			/* Number of keys */
+  uint version;				/* Changed on every insert/delete */
+  uint key_length;			/* Max length of a key image */
+  uint key_slot;			/* Bytes used for a key in a node */
+  uint node_size;			/* Size of one node */
+  uint leaf_keys, node_keys;		/* Max keys in leaf / inner node */
+  uint free_count;
+  myf my_flags;
+} HP_BTREE;
+
+typedef struct st_hp_btree_pos		/* Position in a HP_BTREE */
+{
+  struct st_hp_btree_node *leaf;	/* 0 if no position */
+  uint slot;
+  uint version;				/* Tree version for leaf and slot */
+  uchar *key;				/* Copy of the key at the position */
+} HP_BTREE_POS;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -122,7 +153,7 @@ typedef struct st_hp_keydef		/* Key definition with open */
     #records estimates for heap key scans.
   */
   ha_rows hash_buckets; 
-  TREE rb_tree;
+  HP_BTREE btree;
   int (*write_key)(struct st_heap_info *info, struct st_hp_keydef *keyinfo,
 		   const uchar *record, uchar *recpos);
   int (*delete_key)(struct st_heap_info *info, struct st_hp_keydef *keyinfo,
@@ -134,7 +165,9 @@ typedef struct st_heap_share
 {
   HP_BLOCK block;
   HP_KEYDEF  *keydef;
+  HP_BLOB_DESC *blob_descs;		/* BLOB columns, data kept off-row */
   ulonglong data_length,index_length,max_table_size;
+  ulonglong blob_length;		/* Part of data_length used by BLOBs */
   ulonglong auto_increment;
   ulong min_records,max_records;	/* Params to open */
   ulong records;			/* records */
@@ -147,6 +180,7 @@ typedef struct st_heap_share
   uint visible;                         /* Offset to the visible/deleted mark */
   uint changed;
   uint keys,max_key_length;
+  uint blobs;				/* Number of BLOB columns */
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
   uint open_count;
   uchar *del_link;			/* Link to next block with del. rec */
@@ -173,13 +207,17 @@ typedef struct st_heap_info
   int  mode;				/* Mode of file (READONLY..) */
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
-  uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar *recbuf;                         /* Record buffer for BTREE keys */
+  uchar *blob_buffer;			/* BLOB data of the last read row */
+  size_t blob_buffer_length;
+  uchar **blob_copies;			/* New BLOB data during update */
   enum ha_rkey_function last_find_flag;
-  TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
-  TREE_ELEMENT **last_pos;
+  HP_BTREE_POS last_pos;			/* Position in BTREE key */
   uint key_version;                     /* Version at last read */
   uint file_version;                    /* Version at scan */
   uint lastkey_len;
+  uchar *saved_ptr;			/* Position saved by heap_scan_remember */
+  ulong saved_record, saved_next_block;
   my_bool implicit_emptied;
   THR_LOCK_DATA lock;
   LIST open_list;
@@ -189,9 +227,11 @@ typedef struct st_heap_info
 typedef struct st_heap_create_info
 {
   HP_KEYDEF *keydef;
+  HP_BLOB_DESC *blob_descs;
   uint auto_key;                        /* keynr [1 - maxkey] for auto key */
   uint auto_key_type;
   uint keys;
+  uint blobs;
   uint reclength;
   ulong max_records;
   ulong min_records;
@@ -218,6 +258,8 @@ extern int heap_update(HP_INFO *info,const uchar *old,const uchar *newdata);
 extern int heap_rrnd(HP_INFO *info,uchar *buf,uchar *pos);
 extern int heap_scan_init(HP_INFO *info);
 extern int heap_scan(HP_INFO *info, uchar *record);
+extern void heap_scan_remember(HP_INFO *info);
+extern int heap_scan_restart(HP_INFO *info, uchar *record);
 extern int heap_delete(HP_INFO *info,const uchar *buff);
 extern int heap_info(HP_INFO *info,HEAPINFO *x,int flag);
 extern int heap_create(const char *name,
@@ -214,7 +214,13 @@ enum ha_extra_function {
   /** Finish writing rows during ALTER TABLE...ALGORITHM=COPY. */
   HA_EXTRA_END_ALTER_COPY,
   /** Fake the start of a statement after wsrep_load_data_splitting hack */
-  HA_EXTRA_FAKE_START_STMT
+  HA_EXTRA_FAKE_START_STMT,
+  /**
+    Inform handler that the following index_read_map() or rnd_pos() calls
+    of the current index or table scan are made with keys or rowids in
+    ascending order (used by DS-MRR after sorting them)
+  */
+  HA_EXTRA_SORTED_KEY_LOOKUPS
 };
 
 /* Compatible option, to be deleted in 6.0 */
@@ -17,7 +17,7 @@
 
 #include <my_global.h>
 #ifdef HAVE_COMPRESS
-#include <my_sys.h>
+#include "mysys_priv.h"
 #ifndef SCO
 #include <m_string.h>
 #endif
@@ -92,6 +92,101 @@ void my_az_free(void *dummy __attribute__((unused)), void *address)
   my_free(address);
 }
 
+/*
+  Each compressed packet is an independent zlib stream, but there is no
+  need to allocate and initialize the deflate (~256K) and inflate (~40K)
+  state for every packet. The streams are kept per thread and reset
+  between packets, which produces exactly the same output.
+*/
+
+typedef struct st_my_zlib_streams
+{
+  z_stream deflate, inflate;
+  my_bool deflate_inited, inflate_inited;
+} MY_ZLIB_STREAMS;
+
+static pthread_key(MY_ZLIB_STREAMS*, THR_KEY_zlib);
+static my_bool zlib_key_exists= 0;
+
+static void free_zlib_streams(void *arg)
+{
+  MY_ZLIB_STREAMS *streams= (MY_ZLIB_STREAMS*) arg;
+  if (streams->deflate_inited)
+    deflateEnd(&streams->deflate);
+  if (streams->inflate_inited)
+    inflateEnd(&streams->inflate);
+  my_free(streams);
+}
+
+
+my_bool my_compress_global_init(void)
+{
+  if (!zlib_key_exists)
+  {
+    if (pthread_key_create(&THR_KEY_zlib, free_zlib_streams))
+      return 1;
+    zlib_key_exists= 1;
+  }
+  return 0;
+}
+
+
+void my_compress_global_end(void)
+{
+  if (zlib_key_exists)
+  {
+    zlib_key_exists= 0;
+    pthread_key_delete(THR_KEY_zlib);
+  }
+}
+
+
+/*
+  Free the streams of the current thread. Called from my_thread_end(), as
+  not all platforms support destructors for thread specific data.
+*/
+
+void my_compress_thread_end(void)
+{
+  MY_ZLIB_STREAMS *streams;
+  if (zlib_key_exists &&
+      (streams= my_pthread_getspecific(MY_ZLIB_STREAMS*, THR_KEY_zlib)))
+  {
+    pthread_setspecific(THR_KEY_zlib, 0);
+    free_zlib_streams(streams);
+  }
+}
+
+
+/*
+  Get the zlib streams of the current thread
+
+  RETURN
+    0   The streams could not be allocated; caller should use a local
+        stream instead
+    #   Streams of the current thread
+*/
+
+static MY_ZLIB_STREAMS *my_zlib_streams(void)
+{
+  MY_ZLIB_STREAMS *streams;
+  if (!zlib_key_exists)
+    return 0;
+  if (!(streams= my_pthread_getspecific(MY_ZLIB_STREAMS*, THR_KEY_zlib)))
+  {
+    if (!(streams= (MY_ZLIB_STREAMS*) my_malloc(sizeof(*streams),
+                                                MYF(MY_ZEROFILL))))
+      return 0;
+    if (pthread_setspecific(THR_KEY_zlib, streams))
+    {
+      my_free(streams);
+      return 0;
+    }
+  }
+  return streams;
+}
+
+
 /*
   This works like zlib compress(), but using custom memory allocators to work
   better with my_malloc leak detection and Valgrind.
@@ -99,32 +194,102 @@ void my_az_free(void *dummy __attribute__((unused)), void *address)
 int my_compress_buffer(uchar *dest, size_t *destLen,
                        const uchar *source, size_t sourceLen)
 {
-    z_stream stream;
+    MY_ZLIB_STREAMS *streams= my_zlib_streams();
+    z_stream local_stream, *stream;
     int err;
 
-    stream.next_in = (Bytef*)source;
-    stream.avail_in = (uInt)sourceLen;
-    stream.next_out = (Bytef*)dest;
-    stream.avail_out = (uInt)*destLen;
-    if ((size_t)stream.avail_out != *destLen)
-      return Z_BUF_ERROR;
+    if (streams && streams->deflate_inited)
+    {
+      stream= &streams->deflate;
+      if ((err= deflateReset(stream)) != Z_OK)
+        return err;
+    }
+    else
+    {
+      stream= streams ? &streams->deflate : &local_stream;
+      stream->zalloc = (alloc_func)my_az_allocator;
+      stream->zfree = (free_func)my_az_free;
+      stream->opaque = (voidpf)0;
+
+      err = deflateInit(stream, Z_DEFAULT_COMPRESSION);
+      if (err != Z_OK) return err;
+      if (streams)
+        streams->deflate_inited= 1;
+    }
+
+    stream->next_in = (Bytef*)source;
+    stream->avail_in = (uInt)sourceLen;
+    stream->next_out = (Bytef*)dest;
+    stream->avail_out = (uInt)*destLen;
+
+    if ((size_t)stream->avail_out != *destLen)
+      err = Z_BUF_ERROR;
+    else if ((err = deflate(stream, Z_FINISH)) == Z_STREAM_END)
+    {
+      *destLen = stream->total_out;
+      err = Z_OK;
+    }
+    else if (err == Z_OK)
+      err = Z_BUF_ERROR;
+
+    if (!streams)
+    {
+      int end_err = deflateEnd(stream);
+      if (err == Z_OK)
+        err = end_err;
+    }
+    return err;
+}
+
 
-    stream.zalloc = (alloc_func)my_az_allocator;
-    stream.zfree = (free_func)my_az_free;
-    stream.opaque = (voidpf)0;
+/*
+  Like zlib uncompress(), but using the inflate stream of the current
+  thread.
+*/
 
-    err = deflateInit(&stream, Z_DEFAULT_COMPRESSION);
-    if (err != Z_OK) return err;
+static int my_uncompress_buffer(uchar *dest, uLongf *destLen,
+                                const uchar *source, uLong sourceLen)
+{
+  MY_ZLIB_STREAMS *streams= my_zlib_streams();
+  z_stream local_stream, *stream;
+  int err;
 
-    err = deflate(&stream, Z_FINISH);
-    if (err != Z_STREAM_END) {
-        deflateEnd(&stream);
-        return err == Z_OK ? Z_BUF_ERROR : err;
-    }
-    *destLen = stream.total_out;
+  if (streams && streams->inflate_inited)
+  {
+    stream= &streams->inflate;
+    if ((err= inflateReset(stream)) != Z_OK)
+      return err;
+  }
+  else
+  {
+    stream= streams ? &streams->inflate : &local_stream;
+    stream->zalloc= (alloc_func) my_az_allocator;
+    stream->zfree= (free_func) my_az_free;
+    stream->opaque= (voidpf) 0;
+    stream->next_in= Z_NULL;
+    stream->avail_in= 0;
+    if ((err= inflateInit(stream)) != Z_OK)
+      return err;
+    if (streams)
+      streams->inflate_inited= 1;
+  }
 
-    err = deflateEnd(&stream);
-    return err;
+  stream->next_in= (Bytef*) source;
+  stream->avail_in= (uInt) sourceLen;
+  stream->next_out= (Bytef*) dest;
+  stream->avail_out= (uInt) *destLen;
+
+  if ((err= inflate(stream, Z_FINISH)) == Z_STREAM_END)
+  {
+    *destLen= stream->total_out;
+    err= Z_OK;
+  }
+  else if (err == Z_OK || err == Z_NEED_DICT || err == Z_BUF_ERROR)
+    err= Z_DATA_ERROR;
+
+  if (!streams)
+    inflateEnd(stream);
+  return err;
 }
 
 uchar *my_compress_alloc(const uchar *packet, size_t *len, size_t *complen)
@@ -186,8 +351,7 @@ my_bool my_uncompress(uchar *packet, size_t len, size_t *complen)
       DBUG_RETURN(1);				/* Not enough memory */
 
     tmp_complen= (uLongf) *complen;
-    error= uncompress((Bytef*) compbuf, &tmp_complen, (Bytef*) packet,
-                      (uLong) len);
+    error= my_uncompress_buffer(compbuf, &tmp_complen, packet, (uLong) len);
     *complen= tmp_complen;
     if (error != Z_OK)
     {						/* Probably wrong packet */
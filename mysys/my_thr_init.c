@@ -184,6 +184,11 @@ my_bool my_thread_global_init(void)
   }
   my_thr_key_mysys_exists= 1;
 
+#ifdef HAVE_COMPRESS
+  if (my_compress_global_init())
+    return 1;
+#endif
+
   /* Mutex used by my_thread_init() and after my_thread_destroy_mutex() */
   my_thread_init_internal_mutex();
 
@@ -233,6 +238,9 @@ void my_thread_global_end(void)
   mysql_mutex_unlock(&THR_LOCK_threads);
 
   my_thread_destroy_common_mutex();
+#ifdef HAVE_COMPRESS
+  my_compress_global_end();
+#endif
 
   /*
     Only destroy the mutex & conditions if we don't have other threads around
@@ -348,6 +356,11 @@ void my_thread_end(void)
   */
   PSI_CALL_delete_current_thread();
 
+#ifdef HAVE_COMPRESS
+  /* Free the zlib streams cached by my_compress_buffer()/my_uncompress() */
+  my_compress_thread_end();
+#endif
+
   /*
     We need to disable DBUG early for this thread to ensure that the
     the mutex calls doesn't enable it again
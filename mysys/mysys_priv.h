@@ -108,6 +108,12 @@ size_t sf_malloc_usable_size(void *ptr, my_bool *is_thread_specific);
 
 void my_error_unregister_all(void);
 
+#ifdef HAVE_COMPRESS
+my_bool my_compress_global_init(void);
+void my_compress_global_end(void);
+void my_compress_thread_end(void);
+#endif
+
 #ifndef O_PATH        /* not Linux */
 #if defined(O_SEARCH) /* Illumos */
 #define O_PATH O_SEARCH
@@ -18,13 +18,35 @@
 #include <sql_class.h>
 #include <table.h>
 #include <sql_show.h>
+#include <sql_digest_stream.h>
 #include <mysql/plugin_audit.h>
 #include "query_response_time.h"
 
 
 ulong opt_query_response_time_range_base= QRT_DEFAULT_BASE;
 my_bool opt_query_response_time_stats= 0;
+ulong opt_query_response_time_max_digests= QRT_DEFAULT_MAX_DIGESTS;
 static my_bool opt_query_response_time_flush= 0;
+static bool digest_stats_inited= false, digest_consumer= false;
+
+
+/*
+  Ask the parser to compute statement digests while they are collected
+  for QUERY_RESPONSE_TIME_BY_DIGEST
+*/
+static void query_response_time_update_digest_consumer()
+{
+  bool enable= digest_stats_inited && opt_query_response_time_stats &&
+               opt_query_response_time_max_digests > 0;
+  if (enable != digest_consumer)
+  {
+    digest_consumer= enable;
+    if (enable)
+      digest_consumers++;
+    else
+      digest_consumers--;
+  }
+}
 
 
 static void query_response_time_flush_update(
@@ -34,6 +56,27 @@ static void query_response_time_flush_update(
               const void *save __attribute__((unused)))
 {
   query_response_time_flush();
+  query_response_time_digest_flush();
+}
+
+
+static void query_response_time_stats_update(
+              MYSQL_THD thd __attribute__((unused)),
+              struct st_mysql_sys_var *var __attribute__((unused)),
+              void *tgt, const void *save)
+{
+  *(my_bool *) tgt= *(const my_bool *) save;
+  query_response_time_update_digest_consumer();
+}
+
+
+static void query_response_time_max_digests_update(
+              MYSQL_THD thd __attribute__((unused)),
+              struct st_mysql_sys_var *var __attribute__((unused)),
+              void *tgt, const void *save)
+{
+  *(ulong *) tgt= *(const ulong *) save;
+  query_response_time_update_digest_consumer();
 }
 
 
@@ -45,12 +88,20 @@ static MYSQL_SYSVAR_ULONG(range_base, opt_query_response_time_range_base,
 static MYSQL_SYSVAR_BOOL(stats, opt_query_response_time_stats,
        PLUGIN_VAR_OPCMDARG,
        "Enable or disable query response time statisics collecting",
-       NULL, NULL, FALSE);
+       NULL, query_response_time_stats_update, FALSE);
 static MYSQL_SYSVAR_BOOL(flush, opt_query_response_time_flush,
        PLUGIN_VAR_NOCMDOPT,
        "Update of this variable flushes statistics and re-reads "
        "query_response_time_range_base",
        NULL, query_response_time_flush_update, FALSE);
+static MYSQL_SYSVAR_ULONG(max_digests, opt_query_response_time_max_digests,
+       PLUGIN_VAR_RQCMDARG,
+       "Maximum number of statement digests for which "
+       "QUERY_RESPONSE_TIME_BY_DIGEST collects statistics. Statements with "
+       "new digests are not collected when the limit is reached. "
+       "0 disables collecting statistics by digest",
+       NULL, query_response_time_max_digests_update,
+       QRT_DEFAULT_MAX_DIGESTS, 0, 1024 * 1024, 1);
 #ifndef DBUG_OFF
 static MYSQL_THDVAR_ULONGLONG(exec_time_debug, PLUGIN_VAR_NOCMDOPT,
        "Pretend queries take this many microseconds. When 0 (the default) use "
@@ -64,6 +115,7 @@ static struct st_mysql_sys_var *query_response_time_info_vars[]=
   MYSQL_SYSVAR(range_base),
   MYSQL_SYSVAR(stats),
   MYSQL_SYSVAR(flush),
+  MYSQL_SYSVAR(max_digests),
 #ifndef DBUG_OFF
   MYSQL_SYSVAR(exec_time_debug),
 #endif
@@ -80,6 +132,17 @@ ST_FIELD_INFO query_response_time_fields_info[] =
 };
 
 
+ST_FIELD_INFO query_response_time_by_digest_fields_info[] =
+{
+  { "DIGEST",      QRT_DIGEST_STRING_LENGTH,    MYSQL_TYPE_STRING,  0, 0,               "Digest", 0 },
+  { "DIGEST_TEXT", QRT_DIGEST_TEXT_LENGTH,      MYSQL_TYPE_STRING,  0, 0,               "Digest_text", 0 },
+  { "TIME",        QRT_TIME_STRING_LENGTH,      MYSQL_TYPE_STRING,  0, 0,               "Time", 0 },
+  { "COUNT",       MY_INT32_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONG,    0, MY_I_S_UNSIGNED, "Count", 0 },
+  { "TOTAL",       QRT_TIME_STRING_LENGTH,      MYSQL_TYPE_STRING,  0, 0,               "Total", 0 },
+  { 0, 0, MYSQL_TYPE_NULL, 0, 0, 0, 0 }
+};
+
+
 static int query_response_time_info_init(void *p)
 {
   ST_SCHEMA_TABLE *i_s_query_response_time= (ST_SCHEMA_TABLE *) p;
@@ -94,11 +157,37 @@ static int query_response_time_info_init(void *p)
 static int query_response_time_info_deinit(void *arg __attribute__((unused)))
 {
   opt_query_response_time_stats= 0;
+  query_response_time_update_digest_consumer();
   query_response_time_free();
   return 0;
 }
 
 
+static int query_response_time_by_digest_info_init(void *p)
+{
+  ST_SCHEMA_TABLE *i_s_query_response_time_by_digest= (ST_SCHEMA_TABLE *) p;
+  i_s_query_response_time_by_digest->fields_info=
+    query_response_time_by_digest_fields_info;
+  i_s_query_response_time_by_digest->fill_table=
+    query_response_time_digest_fill;
+  i_s_query_response_time_by_digest->reset_table=
+    query_response_time_digest_flush;
+  query_response_time_digest_init();
+  digest_stats_inited= true;
+  query_response_time_update_digest_consumer();
+  return 0;
+}
+
+
+static int query_response_time_by_digest_info_deinit(void *arg __attribute__((unused)))
+{
+  digest_stats_inited= false;
+  query_response_time_update_digest_consumer();
+  query_response_time_digest_free();
+  return 0;
+}
+
+
 static struct st_mysql_information_schema query_response_time_info_descriptor=
 { MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
 
@@ -113,13 +202,18 @@ static void query_response_time_audit_notify(MYSQL_THD thd,
   if (event_general->event_subclass == MYSQL_AUDIT_GENERAL_STATUS &&
       opt_query_response_time_stats)
   {
+    ulonglong query_time= thd->utime_after_query - thd->utime_after_lock;
 #ifndef DBUG_OFF
     if (THDVAR(thd, exec_time_debug))
-      query_response_time_collect(thd->lex->sql_command != SQLCOM_SET_OPTION ?
-                                  THDVAR(thd, exec_time_debug) : 0);
-    else
+      query_time= thd->lex->sql_command != SQLCOM_SET_OPTION ?
+                  THDVAR(thd, exec_time_debug) : 0;
 #endif
-    query_response_time_collect(thd->utime_after_query - thd->utime_after_lock);
+    query_response_time_collect(query_time);
+
+    if (digest_consumer && thd->m_digest &&
+        !thd->m_digest->m_digest_storage.is_empty())
+      query_response_time_digest_collect(&thd->m_digest->m_digest_storage,
+                                         query_time);
   }
 }
 
@@ -161,5 +255,20 @@ maria_declare_plugin(query_response_time)
   NULL,
   "1.0",
   MariaDB_PLUGIN_MATURITY_STABLE
+},
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &query_response_time_info_descriptor,
+  "QUERY_RESPONSE_TIME_BY_DIGEST",
+  "MariaDB Corporation",
+  "Query Response Time Distribution by Statement Digest INFORMATION_SCHEMA Plugin",
+  PLUGIN_LICENSE_GPL,
+  query_response_time_by_digest_info_init,
+  query_response_time_by_digest_info_deinit,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_STABLE
 }
 maria_declare_plugin_end;
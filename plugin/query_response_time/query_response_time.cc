@@ -6,6 +6,8 @@
 #include "table.h"
 #include "field.h"
 #include "sql_show.h"
+#include "sql_digest.h"
+#include "hash.h"
 #include "query_response_time.h"
 
 #define TIME_STRING_POSITIVE_POWER_LENGTH QRT_TIME_STRING_POSITIVE_POWER_LENGTH
@@ -243,6 +245,10 @@ class collector
   {
     return m_time.total(index);
   }
+  utility& get_utility()
+  {
+    return m_utility;
+  }
 private:
   utility          m_utility;
   time_collector   m_time;
@@ -250,6 +256,160 @@ class collector
 
 static collector g_collector;
 
+/*
+  Response time distribution of the statements with the same digest.
+  The token array of the digest follows the structure in memory.
+*/
+struct digest_stat
+{
+  ulonglong          hash;
+  time_collector     time;
+  sql_digest_storage digest;
+
+  digest_stat(utility& u, ulonglong digest_hash,
+              const sql_digest_storage *from)
+    : hash(digest_hash), time(u)
+  {
+    digest.reset(reinterpret_cast<uchar*>(this + 1), from->m_byte_count);
+    digest.copy(from);
+  }
+};
+
+static uchar *digest_stat_get_key(const uchar *record, size_t *length,
+                                  my_bool not_used __attribute__((unused)))
+{
+  *length= sizeof(ulonglong);
+  return (uchar*) &reinterpret_cast<const digest_stat*>(record)->hash;
+}
+
+static void digest_stat_free(void *record)
+{
+  reinterpret_cast<digest_stat*>(record)->~digest_stat();
+  my_free(record);
+}
+
+/*
+  Statistics by digest, kept in a hash growing up to
+  query_response_time_max_digests elements. Statements with the new
+  digests are not collected when the hash is full.
+*/
+class digest_collector
+{
+public:
+  digest_collector(utility& u): m_utility(&u), m_inited(false) { }
+public:
+  void init()
+  {
+    mysql_rwlock_init(0, &m_lock);
+    my_hash_init(&m_digests, &my_charset_bin, 64, 0, 0,
+                 digest_stat_get_key, digest_stat_free, 0);
+    m_inited= true;
+  }
+  void free()
+  {
+    if (!m_inited)
+      return;
+    m_inited= false;
+    mysql_rwlock_wrlock(&m_lock);
+    my_hash_free(&m_digests);
+    mysql_rwlock_unlock(&m_lock);
+    mysql_rwlock_destroy(&m_lock);
+  }
+  void flush()
+  {
+    mysql_rwlock_wrlock(&m_lock);
+    my_hash_reset(&m_digests);
+    mysql_rwlock_unlock(&m_lock);
+  }
+  void collect(const sql_digest_storage *digest, ulonglong time)
+  {
+    ulonglong hash= compute_digest_hash(digest);
+    digest_stat *stat;
+
+    mysql_rwlock_rdlock(&m_lock);
+    stat= reinterpret_cast<digest_stat*>
+      (my_hash_search(&m_digests, (uchar*) &hash, sizeof(hash)));
+    if (stat)
+      stat->time.collect(time);
+    mysql_rwlock_unlock(&m_lock);
+    if (stat || m_digests.records >= opt_query_response_time_max_digests)
+      return;
+
+    mysql_rwlock_wrlock(&m_lock);
+    stat= reinterpret_cast<digest_stat*>
+      (my_hash_search(&m_digests, (uchar*) &hash, sizeof(hash)));
+    if (!stat && m_digests.records < opt_query_response_time_max_digests)
+    {
+      void *mem= my_malloc(sizeof(digest_stat) + digest->m_byte_count, MYF(0));
+      if (mem)
+      {
+        stat= new (mem) digest_stat(*m_utility, hash, digest);
+        if (my_hash_insert(&m_digests, (uchar*) stat))
+        {
+          digest_stat_free(stat);
+          stat= NULL;
+        }
+      }
+    }
+    if (stat)
+      stat->time.collect(time);
+    mysql_rwlock_unlock(&m_lock);
+  }
+  int fill(THD* thd, TABLE_LIST *tables, COND *cond)
+  {
+    DBUG_ENTER("fill_schema_query_response_time_by_digest");
+    TABLE        *table= static_cast<TABLE*>(tables->table);
+    Field        **fields= table->field;
+    String       digest_text;
+    int          res= 0;
+    mysql_rwlock_rdlock(&m_lock);
+    for (ulong n= 0; !res && n < m_digests.records; n++)
+    {
+      digest_stat *stat=
+        reinterpret_cast<digest_stat*>(my_hash_element(&m_digests, n));
+      char digest[QRT_DIGEST_STRING_LENGTH + 1];
+      my_snprintf(digest, sizeof(digest), "%016llx", stat->hash);
+      compute_digest_text(&stat->digest, &digest_text);
+      for(uint i= 0, count= m_utility->bound_count() + 1; count > i; ++i)
+      {
+        char time[TIME_STRING_BUFFER_LENGTH];
+        char total[TOTAL_STRING_BUFFER_LENGTH];
+        if (!stat->time.count(i))
+          continue;
+        if(i == m_utility->bound_count())
+        {
+          memcpy(time,TIME_OVERFLOW,sizeof(TIME_OVERFLOW));
+          memcpy(total,TIME_OVERFLOW,sizeof(TIME_OVERFLOW));
+        }
+        else
+        {
+          print_time(time, sizeof(time), TIME_STRING_FORMAT,
+                     m_utility->bound(i));
+          print_time(total, sizeof(total), TOTAL_STRING_FORMAT,
+                     stat->time.total(i));
+        }
+        fields[0]->store(digest, QRT_DIGEST_STRING_LENGTH, system_charset_info);
+        fields[1]->store(digest_text.ptr(), digest_text.length(),
+                         &my_charset_utf8_bin);
+        fields[2]->store(time,strlen(time),system_charset_info);
+        fields[3]->store((longlong)stat->time.count(i),true);
+        fields[4]->store(total,strlen(total),system_charset_info);
+        if ((res= schema_table_store_record(thd, table)))
+          break;
+      }
+    }
+    mysql_rwlock_unlock(&m_lock);
+    DBUG_RETURN(res);
+  }
+private:
+  utility          *m_utility;
+  bool             m_inited;
+  mysql_rwlock_t   m_lock;
+  HASH             m_digests;
+};
+
+static digest_collector g_digest_collector(g_collector.get_utility());
+
 } // namespace query_response_time
 
 void query_response_time_init()
@@ -275,4 +435,31 @@ int query_response_time_fill(THD* thd, TABLE_LIST *tables, COND *cond)
 {
   return query_response_time::g_collector.fill(thd,tables,cond);
 }
+
+void query_response_time_digest_init()
+{
+  query_response_time::g_digest_collector.init();
+}
+
+void query_response_time_digest_free()
+{
+  query_response_time::g_digest_collector.free();
+}
+
+int query_response_time_digest_flush()
+{
+  query_response_time::g_digest_collector.flush();
+  return 0;
+}
+
+void query_response_time_digest_collect(const sql_digest_storage *digest,
+                                        ulonglong query_time)
+{
+  query_response_time::g_digest_collector.collect(digest, query_time);
+}
+
+int query_response_time_digest_fill(THD* thd, TABLE_LIST *tables, COND *cond)
+{
+  return query_response_time::g_digest_collector.fill(thd,tables,cond);
+}
 #endif // HAVE_RESPONSE_TIME_DISTRIBUTION
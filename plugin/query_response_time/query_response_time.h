@@ -43,6 +43,14 @@
 
 #define QRT_DEFAULT_BASE 10
 
+/*
+  Length of DIGEST, hexadecimal 64 bit hash, and maximum
+  length of DIGEST_TEXT in QUERY_RESPONSE_TIME_BY_DIGEST
+*/
+#define QRT_DIGEST_STRING_LENGTH 16
+#define QRT_DIGEST_TEXT_LENGTH 65535
+#define QRT_DEFAULT_MAX_DIGESTS 1000
+
 #define QRT_TIME_STRING_LENGTH				\
   MY_MAX( (QRT_TIME_STRING_POSITIVE_POWER_LENGTH + 1 /* '.' */ + 6 /*QRT_TIME_STRING_NEGATIVE_POWER_LENGTH*/), \
        (sizeof(QRT_TIME_OVERFLOW) - 1) )
@@ -53,6 +61,8 @@
 
 extern ST_SCHEMA_TABLE query_response_time_table;
 
+struct sql_digest_storage;
+
 #ifdef HAVE_RESPONSE_TIME_DISTRIBUTION
 extern void query_response_time_init   ();
 extern void query_response_time_free   ();
@@ -60,8 +70,17 @@ extern int query_response_time_flush  ();
 extern void query_response_time_collect(ulonglong query_time);
 extern int  query_response_time_fill   (THD* thd, TABLE_LIST *tables, COND *cond);
 
+extern void query_response_time_digest_init   ();
+extern void query_response_time_digest_free   ();
+extern int  query_response_time_digest_flush  ();
+extern void query_response_time_digest_collect(const sql_digest_storage *digest,
+                                               ulonglong query_time);
+extern int  query_response_time_digest_fill   (THD* thd, TABLE_LIST *tables,
+                                               COND *cond);
+
 extern ulong   opt_query_response_time_range_base;
 extern my_bool opt_query_response_time_stats;
+extern ulong   opt_query_response_time_max_digests;
 #endif // HAVE_RESPONSE_TIME_DISTRIBUTION
 
 #endif // QUERY_RESPONSE_TIME_H
@@ -8969,6 +8969,7 @@ int ha_partition::extra(enum ha_extra_function operation)
   case HA_EXTRA_BEGIN_ALTER_COPY:
   case HA_EXTRA_END_ALTER_COPY:
   case HA_EXTRA_FAKE_START_STMT:
+  case HA_EXTRA_SORTED_KEY_LOOKUPS:
     DBUG_RETURN(loop_partitions(extra_cb, &operation));
   default:
   {
@@ -1006,6 +1006,7 @@ enum enum_schema_tables
   SCH_TABLE_CONSTRAINTS,
   SCH_TABLE_NAMES,
   SCH_TABLE_PRIVILEGES,
+  SCH_THREAD_POOL_GROUPS,
   SCH_TRIGGERS,
   SCH_USER_PRIVILEGES,
   SCH_VIEWS,
@@ -0,0 +1,138 @@
+/* Copyright (c) 2019, MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#ifndef HYPERLOGLOG_INCLUDED
+#define HYPERLOGLOG_INCLUDED
+
+#include <my_global.h>
+#include <math.h>
+
+/* Number of hash bits used to select a register of the sketch */
+#define HLL_PRECISION 14
+#define HLL_REGISTERS (1U << HLL_PRECISION)
+
+/**
+  A HyperLogLog sketch estimating the number of distinct values added to it.
+
+  Every value is represented by a 64-bit hash. The first HLL_PRECISION
+  bits of the hash select a register, and the register keeps the maximum
+  position of the first set bit seen in the remaining bits. The standard
+  error of the estimate is 1.04/sqrt(HLL_REGISTERS), that is 0.8%, and
+  the sketch takes HLL_REGISTERS bytes whatever the number of values.
+
+  The estimate is calculated with the estimator of O. Ertl, "New
+  cardinality estimation algorithms for HyperLogLog sketches" (2017),
+  which is unbiased for small as well as for big numbers of values and
+  needs no empirical correction tables.
+*/
+
+class Hyperloglog
+{
+  uchar registers[HLL_REGISTERS];
+
+  /*
+    Scramble the bits of a value hash so that every bit of the result
+    depends on every bit of the argument (the finalizer of MurmurHash3).
+    The hash functions of the collations do not distribute the values
+    uniformly enough for the sketch.
+  */
+  static ulonglong mix(ulonglong hash)
+  {
+    hash^= hash >> 33;
+    hash*= 0xff51afd7ed558ccdULL;
+    hash^= hash >> 33;
+    hash*= 0xc4ceb9fe1a85ec53ULL;
+    hash^= hash >> 33;
+    return hash;
+  }
+
+  static double sigma(double x)
+  {
+    double y= 1.0, z= x, prev_z;
+    do
+    {
+      x*= x;
+      prev_z= z;
+      z+= x * y;
+      y+= y;
+    } while (z != prev_z);
+    return z;
+  }
+
+  static double tau(double x)
+  {
+    if (x == 0.0 || x == 1.0)
+      return 0.0;
+    double y= 1.0, z= 1.0 - x, prev_z;
+    do
+    {
+      x= sqrt(x);
+      prev_z= z;
+      y*= 0.5;
+      z-= (1.0 - x) * (1.0 - x) * y;
+    } while (z != prev_z);
+    return z / 3;
+  }
+
+public:
+  Hyperloglog() { clear(); }
+
+  void clear() { bzero(registers, sizeof(registers)); }
+
+  /**
+    Add a value to the sketch
+
+    @param hash  A hash of the value. Equal values must have equal hashes,
+                 the hash does not need to be uniformly distributed.
+  */
+  void add(ulonglong hash)
+  {
+    const uchar max_rank= 64 - HLL_PRECISION + 1;
+    hash= mix(hash);
+    uint reg= (uint) (hash >> (64 - HLL_PRECISION));
+    ulonglong rest= hash << HLL_PRECISION;
+    uchar rank= 1;
+    while (rank < max_rank && !(rest & (1ULL << 63)))
+    {
+      rest<<= 1;
+      rank++;
+    }
+    if (registers[reg] < rank)
+      registers[reg]= rank;
+  }
+
+  /** Estimate the number of distinct values added to the sketch */
+  double estimate() const
+  {
+    const uint max_rank= 64 - HLL_PRECISION + 1;
+    const double m= HLL_REGISTERS;
+    uint counts[max_rank + 1];
+
+    bzero(counts, sizeof(counts));
+    for (uint i= 0; i < HLL_REGISTERS; i++)
+      counts[registers[i]]++;
+    if (counts[0] == HLL_REGISTERS)
+      return 0.0;
+
+    double z= m * tau(1.0 - counts[max_rank] / m);
+    for (uint rank= max_rank - 1; rank >= 1; rank--)
+      z= 0.5 * (z + counts[rank]);
+    z+= m * sigma(counts[0] / m);
+    /* alpha= 1 / (2 * ln(2)) is the limit of the bias correction factor */
+    return m * m / (2 * M_LN2 * z);
+  }
+};
+
+#endif /* HYPERLOGLOG_INCLUDED */
@@ -8492,7 +8492,7 @@ void Item_cache_wrapper::cleanup()
 
 
 /**
-  Create an expression cache that uses a temporary table
+  Create an expression cache that uses an in-memory hash table
 
   @param thd           Thread handle
   @param depends_on    Parameters of the expression to create cache for
@@ -8500,8 +8500,8 @@ void Item_cache_wrapper::cleanup()
   @details
   The function takes 'depends_on' as the list of all parameters for
   the expression wrapped into this object and creates an expression
-  cache in a temporary table containing the field for the parameters
-  and the result of the expression.
+  cache that keeps the results of the expression for the values of the
+  parameters.
 
   @retval FALSE OK
   @retval TRUE  Error
@@ -8511,7 +8511,7 @@ bool Item_cache_wrapper::set_cache(THD *thd)
 {
   DBUG_ENTER("Item_cache_wrapper::set_cache");
   DBUG_ASSERT(expr_cache == 0);
-  expr_cache= new Expression_cache_tmptable(thd, parameters, expr_value);
+  expr_cache= new Expression_cache_hash(thd, parameters, expr_value);
   DBUG_RETURN(expr_cache == NULL);
 }
 
@@ -8522,7 +8522,7 @@ Expression_cache_tracker* Item_cache_wrapper::init_tracker(MEM_ROOT *mem_root)
     Expression_cache_tracker* tracker=
       new(mem_root) Expression_cache_tracker(expr_cache);
     if (tracker)
-      ((Expression_cache_tmptable *)expr_cache)->set_tracker(tracker);
+      ((Expression_cache_hash *)expr_cache)->set_tracker(tracker);
     return tracker;
   }
   return NULL;
@@ -8547,11 +8547,11 @@ Item *Item_cache_wrapper::check_cache()
   DBUG_ENTER("Item_cache_wrapper::check_cache");
   if (expr_cache)
   {
-    Expression_cache_tmptable::result res;
+    Expression_cache_hash::result res;
     Item *cached_value;
     init_on_demand();
     res= expr_cache->check_value(&cached_value);
-    if (res == Expression_cache_tmptable::HIT)
+    if (res == Expression_cache_hash::HIT)
       DBUG_RETURN(cached_value);
   }
   DBUG_RETURN(NULL);
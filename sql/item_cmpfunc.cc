@@ -29,6 +29,7 @@
 #include "mariadb.h"
 #include "sql_priv.h"
 #include <m_ctype.h>
+#include <my_bit.h>
 #include "sql_select.h"
 #include "sql_parse.h"                          // check_stack_overrun
 #include "sql_base.h"                  // dynamic_column_error_message
@@ -3714,10 +3715,66 @@ void in_row::set(uint pos, Item *item)
   DBUG_VOID_RETURN;
 }
 
+/*
+  Lists of at least this many integer values are searched with a hash table
+  instead of the binary search
+*/
+#define IN_LONGLONG_HASH_THRESHOLD 8
+
 in_longlong::in_longlong(THD *thd, uint elements)
   :in_vector(thd, elements, sizeof(packed_longlong),
-             (qsort2_cmp) cmp_longlong, 0)
-{}
+             (qsort2_cmp) cmp_longlong, 0),
+   hash_table(NULL), hash_mask(0)
+{
+  if (elements >= IN_LONGLONG_HASH_THRESHOLD)
+  {
+    /* Keep the hash table at most half full */
+    uint slots= my_round_up_to_next_power(elements) * 2;
+    if ((hash_table= (uint*) thd_calloc(thd, slots * sizeof(uint))))
+      hash_mask= slots - 1;
+  }
+}
+
+void in_longlong::sort()
+{
+  in_vector::sort();
+  if (!hash_table)
+    return;
+
+  packed_longlong *values= (packed_longlong*) base;
+  bzero(hash_table, (hash_mask + 1) * sizeof(uint));
+  for (uint pos= 0; pos < used_count; pos++)
+  {
+    uint slot= hash_slot(values[pos].val);
+    while (hash_table[slot])
+      slot= (slot + 1) & hash_mask;
+    hash_table[slot]= pos + 1;
+  }
+}
+
+/*
+  Values equal according to cmp_longlong() have the same 'val', so they
+  are in the same chain of occupied slots.
+*/
+
+bool in_longlong::find(Item *item)
+{
+  if (!hash_table)
+    return in_vector::find(item);
+
+  packed_longlong *value= (packed_longlong*) get_value(item);
+  if (!value)
+    return false;                               // Null value
+
+  packed_longlong *values= (packed_longlong*) base;
+  for (uint slot= hash_slot(value->val); hash_table[slot];
+       slot= (slot + 1) & hash_mask)
+  {
+    if (!cmp_longlong(0, values + hash_table[slot] - 1, value))
+      return true;
+  }
+  return false;
+}
 
 void in_longlong::set(uint pos,Item *item)
 {
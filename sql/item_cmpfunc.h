@@ -1330,11 +1330,11 @@ class in_vector :public Sql_alloc
   virtual ~in_vector() {}
   virtual void set(uint pos,Item *item)=0;
   virtual uchar *get_value(Item *item)=0;
-  void sort()
+  virtual void sort()
   {
     my_qsort2(base,used_count,size,compare,(void*)collation);
   }
-  bool find(Item *item);
+  virtual bool find(Item *item);
   
   /* 
     Create an instance of Item_{type} (e.g. Item_decimal) constant object
@@ -1408,10 +1408,25 @@ class in_longlong :public in_vector
     longlong val;
     longlong unsigned_flag;  // Use longlong, not bool, to preserve alignment
   } tmp;
+  /*
+    For long lists the positions of the values in 'base' plus one are also
+    put into an open addressing hash table (0 marks a free slot), so that
+    find() does not have to do a binary search calling 'compare' at every
+    step.
+  */
+  uint *hash_table;
+  uint hash_mask;
+  uint hash_slot(longlong val) const
+  {
+    return (uint) (((ulonglong) val * 0x9E3779B97F4A7C15ULL) >> 32) &
+           hash_mask;
+  }
 public:
   in_longlong(THD *thd, uint elements);
   void set(uint pos,Item *item);
   uchar *get_value(Item *item);
+  void sort();
+  bool find(Item *item);
   Item* create_item(THD *thd);
   void value_to_item(uint pos, Item *item)
   {
@@ -260,6 +260,19 @@ class Create_func_aes_decrypt : public Create_func_arg2
 };
 
 
+class Create_func_approx_count_distinct : public Create_func_arg1
+{
+public:
+  virtual Item *create_1_arg(THD *thd, Item *arg1);
+
+  static Create_func_approx_count_distinct s_singleton;
+
+protected:
+  Create_func_approx_count_distinct() {}
+  virtual ~Create_func_approx_count_distinct() {}
+};
+
+
 #ifdef HAVE_SPATIAL
 class Create_func_area : public Create_func_arg1
 {
@@ -3697,6 +3710,16 @@ Create_func_aes_decrypt::create_2_arg(THD *thd, Item *arg1, Item *arg2)
 }
 
 
+Create_func_approx_count_distinct
+  Create_func_approx_count_distinct::s_singleton;
+
+Item*
+Create_func_approx_count_distinct::create_1_arg(THD *thd, Item *arg1)
+{
+  return new (thd->mem_root) Item_sum_approx_count_distinct(thd, arg1);
+}
+
+
 #ifdef HAVE_SPATIAL
 Create_func_area Create_func_area::s_singleton;
 
@@ -7106,6 +7129,7 @@ static Native_func_registry func_array[] =
   { { STRING_WITH_LEN("ADDTIME") }, BUILDER(Create_func_addtime)},
   { { STRING_WITH_LEN("AES_DECRYPT") }, BUILDER(Create_func_aes_decrypt)},
   { { STRING_WITH_LEN("AES_ENCRYPT") }, BUILDER(Create_func_aes_encrypt)},
+  { { STRING_WITH_LEN("APPROX_COUNT_DISTINCT") }, BUILDER(Create_func_approx_count_distinct)},
   { { STRING_WITH_LEN("AREA") }, GEOM_BUILDER(Create_func_area)},
   { { STRING_WITH_LEN("ASBINARY") }, GEOM_BUILDER(Create_func_as_wkb)},
   { { STRING_WITH_LEN("ASIN") }, BUILDER(Create_func_asin)},
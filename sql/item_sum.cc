@@ -1888,6 +1888,80 @@ void Item_sum_count::cleanup()
 }
 
 
+/*
+  Approximate count of distinct values
+*/
+
+void Item_sum_approx_count_distinct::clear()
+{
+  sketch.clear();
+}
+
+
+/**
+  Add the hash of the argument value to the sketch.
+
+  Values equal according to the comparison of COUNT(DISTINCT) must get
+  equal hashes, so strings are hashed with the hash function of their
+  collation, and -0.0 is hashed as 0.0.
+*/
+
+bool Item_sum_approx_count_distinct::add()
+{
+  Item *arg= args[0];
+  ulonglong hash;
+
+  switch (arg->result_type()) {
+  case INT_RESULT:
+  {
+    longlong nr= arg->val_int();
+    if (arg->null_value)
+      return 0;
+    hash= (ulonglong) nr;
+    break;
+  }
+  case REAL_RESULT:
+  {
+    double nr= arg->val_real();
+    if (arg->null_value)
+      return 0;
+    if (nr == 0.0)
+      nr= 0.0;
+    memcpy(&hash, &nr, sizeof(hash));
+    break;
+  }
+  default:
+  {
+    StringBuffer<MAX_FIELD_WIDTH> buf;
+    String *res= arg->val_str(&buf);
+    if (!res)
+      return 0;
+    ulong nr1= 1, nr2= 4;
+    CHARSET_INFO *cs= res->charset();
+    cs->coll->hash_sort(cs, (const uchar *) res->ptr(), res->length(),
+                        &nr1, &nr2);
+    hash= nr1;
+    break;
+  }
+  }
+  sketch.add(hash);
+  return 0;
+}
+
+
+longlong Item_sum_approx_count_distinct::val_int()
+{
+  DBUG_ASSERT(fixed == 1);
+  return (longlong) rint(sketch.estimate());
+}
+
+
+Item *Item_sum_approx_count_distinct::copy_or_same(THD* thd)
+{
+  return new (thd->mem_root) Item_sum_approx_count_distinct(thd, this);
+}
+
+
 /*
   Avgerage
 */
@@ -2300,12 +2374,131 @@ Item *Item_sum_variance::result_item(THD *thd, Field *field)
 void Item_sum_hybrid::clear()
 {
   DBUG_ENTER("Item_sum_hybrid::clear");
+  if (as_window_function)
+    clear_as_window();
   value->clear();
   null_value= 1;
   DBUG_VOID_RETURN;
 }
 
 
+void Item_sum_hybrid::setup_window_func(THD *thd __attribute__((unused)),
+                                        Window_spec *window_spec
+                                        __attribute__((unused)))
+{
+  as_window_function= TRUE;
+  result_value= value;
+  window_queue= 0;
+  window_queue_size= 0;
+  clear_as_window();
+}
+
+
+void Item_sum_hybrid::clear_as_window()
+{
+  window_queue_start= window_queue_length= 0;
+  window_rows_added= window_rows_removed= 0;
+  value= result_value;
+}
+
+
+/*
+  Add the value of arg_cache as the newest row of the window frame
+
+  NOTES
+    The newer rows with a better or equal value are dropped from the
+    queue. The comparator compares arg_cache with the item 'value' points
+    to, so 'value' is set to each of the compared entries in turn and is
+    left pointing to the value of the oldest row in the queue, that is
+    the result.
+*/
+
+bool Item_sum_hybrid::add_as_window()
+{
+  ulonglong row= window_rows_added++;
+  Window_entry *entry;
+  DBUG_ENTER("Item_sum_hybrid::add_as_window");
+
+  if (arg_cache->null_value)
+    DBUG_RETURN(0);
+
+  while (window_queue_length)
+  {
+    value= window_entry(window_queue_length - 1)->value;
+    if (cmp->compare() * cmp_sign > 0)
+      break;
+    window_queue_length--;
+  }
+
+  if (window_queue_length == window_queue_size)
+  {
+    /*
+      The queue is full, move it to a buffer twice as big.
+      The caches of the entries are kept, to be reused.
+    */
+    THD *thd= current_thd;
+    uint new_size= MY_MAX(window_queue_size * 2, 16);
+    Window_entry *new_queue;
+    if (!(new_queue= (Window_entry*) thd->calloc(sizeof(Window_entry) *
+                                                  new_size)))
+      DBUG_RETURN(1);
+    for (uint i= 0; i < window_queue_size; i++)
+      new_queue[i]= *window_entry(i);
+    window_queue= new_queue;
+    window_queue_size= new_size;
+    window_queue_start= 0;
+  }
+
+  entry= window_entry(window_queue_length);
+  if (!entry->value)
+  {
+    THD *thd= current_thd;
+    if (!(entry->value= args[0]->get_cache(thd)))
+      DBUG_RETURN(1);
+    entry->value->setup(thd, args[0]);
+  }
+  entry->value->store(arg_cache);
+  entry->value->cache_value();
+  entry->row= row;
+  window_queue_length++;
+
+  value= window_entry(0)->value;
+  null_value= 0;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Remove the oldest row from the window frame
+*/
+
+void Item_sum_hybrid::remove()
+{
+  DBUG_ENTER("Item_sum_hybrid::remove");
+  DBUG_ASSERT(as_window_function);
+  if (window_rows_removed == window_rows_added)
+    DBUG_VOID_RETURN;                           // Nothing to remove
+
+  if (window_queue_length &&
+      window_entry(0)->row == window_rows_removed)
+  {
+    window_queue_start= (window_queue_start + 1) % window_queue_size;
+    window_queue_length--;
+  }
+  window_rows_removed++;
+
+  if (window_queue_length)
+    value= window_entry(0)->value;
+  else
+  {
+    value= result_value;
+    value->clear();
+    null_value= 1;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
 bool
 Item_sum_hybrid::get_date(THD *thd, MYSQL_TIME *ltime, date_mode_t fuzzydate)
 {
@@ -2394,6 +2587,14 @@ void Item_sum_hybrid::cleanup()
 {
   DBUG_ENTER("Item_sum_hybrid::cleanup");
   Item_sum::cleanup();
+  if (as_window_function)
+  {
+    /* The entries of the queue were allocated on the execution mem_root */
+    value= result_value;
+    window_queue= 0;
+    window_queue_size= 0;
+    as_window_function= FALSE;
+  }
   if (cmp)
     delete cmp;
   cmp= 0;
@@ -2446,6 +2647,12 @@ bool Item_sum_min::add()
   DBUG_ENTER("Item_sum_min::add");
   DBUG_PRINT("enter", ("this: %p", this));
 
+  if (as_window_function)
+  {
+    arg_cache->cache_value();
+    DBUG_RETURN(add_as_window());
+  }
+
   if (unlikely(direct_added))
   {
     /* Change to use direct_item */
@@ -2486,6 +2693,12 @@ bool Item_sum_max::add()
   DBUG_ENTER("Item_sum_max::add");
   DBUG_PRINT("enter", ("this: %p", this));
 
+  if (as_window_function)
+  {
+    arg_cache->cache_value();
+    DBUG_RETURN(add_as_window());
+  }
+
   if (unlikely(direct_added))
   {
     /* Change to use direct_item */
@@ -25,6 +25,7 @@
 
 #include <my_tree.h>
 #include "sql_udf.h"                            /* udf_handler */
+#include "hyperloglog.h"
 
 class Item_sum;
 class Aggregator_distinct;
@@ -352,7 +353,7 @@ class Item_sum :public Item_func_or_sum
   { COUNT_FUNC, COUNT_DISTINCT_FUNC, SUM_FUNC, SUM_DISTINCT_FUNC, AVG_FUNC,
     AVG_DISTINCT_FUNC, MIN_FUNC, MAX_FUNC, STD_FUNC,
     VARIANCE_FUNC, SUM_BIT_FUNC, UDF_SUM_FUNC, GROUP_CONCAT_FUNC,
-    ROW_NUMBER_FUNC, RANK_FUNC, DENSE_RANK_FUNC, PERCENT_RANK_FUNC,
+    APPROX_COUNT_DISTINCT_FUNC, ROW_NUMBER_FUNC, RANK_FUNC, DENSE_RANK_FUNC, PERCENT_RANK_FUNC,
     CUME_DIST_FUNC, NTILE_FUNC, FIRST_VALUE_FUNC, LAST_VALUE_FUNC,
     NTH_VALUE_FUNC, LEAD_FUNC, LAG_FUNC, PERCENTILE_CONT_FUNC,
     PERCENTILE_DISC_FUNC, SP_AGGREGATE_FUNC
@@ -428,6 +429,7 @@ class Item_sum :public Item_func_or_sum
     case SUM_BIT_FUNC:
     case UDF_SUM_FUNC:
     case GROUP_CONCAT_FUNC:
+    case APPROX_COUNT_DISTINCT_FUNC:
       return true;
     default:
       return false;
@@ -897,6 +899,44 @@ class Item_sum_count :public Item_sum_int
 };
 
 
+/**
+  APPROX_COUNT_DISTINCT(expr): an estimate of COUNT(DISTINCT expr)
+
+  The distinct values are not stored, they are only added to a
+  HyperLogLog sketch, so the function takes the same small amount of
+  memory and time per row whatever the number of distinct values.
+*/
+
+class Item_sum_approx_count_distinct :public Item_sum_int
+{
+  Hyperloglog sketch;
+
+  void clear();
+  bool add();
+
+public:
+  Item_sum_approx_count_distinct(THD *thd, Item *item_par):
+    Item_sum_int(thd, item_par)
+  {
+    /* The sketch is too big to be kept in a temporary table field */
+    quick_group= 0;
+  }
+  Item_sum_approx_count_distinct(THD *thd,
+                                 Item_sum_approx_count_distinct *item):
+    Item_sum_int(thd, item), sketch(item->sketch)
+  {}
+  enum Sumfunctype sum_func () const { return APPROX_COUNT_DISTINCT_FUNC; }
+  void no_rows_in_result() { clear(); }
+  longlong val_int();
+  void reset_field() { DBUG_ASSERT(0); }        // not used
+  void update_field() { DBUG_ASSERT(0); }       // not used
+  const char *func_name() const { return "approx_count_distinct("; }
+  Item *copy_or_same(THD* thd);
+  Item *get_copy(THD *thd)
+  { return get_item_copy<Item_sum_approx_count_distinct>(thd, this); }
+};
+
+
 class Item_sum_avg :public Item_sum_sum
 {
 public:
@@ -1048,18 +1088,50 @@ class Item_sum_hybrid :public Item_sum, public Type_handler_hybrid_field_type
   bool was_values;  // Set if we have found at least one row (for max/min only)
   bool was_null_value;
 
+  /*
+    When used as a window function, the rows of the frame that can still
+    become the result after older rows are removed from the frame.
+    It is a circular queue ordered by the row number; the values are
+    strictly increasing (MIN) or decreasing (MAX) from the oldest row, so
+    the result is always the value of the oldest row in the queue.
+    A row is dropped from the queue as soon as a newer row with a better
+    or equal value is added, thus each row of the partition is added to
+    and removed from the queue at most once.
+  */
+  struct Window_entry
+  {
+    Item_cache *value;
+    ulonglong row;
+  };
+  bool as_window_function;
+  Window_entry *window_queue;
+  uint window_queue_size, window_queue_start, window_queue_length;
+  // Numbers of rows added to and removed from the frame
+  ulonglong window_rows_added, window_rows_removed;
+  // The value the result is kept in when the function is not a window one
+  Item_cache *result_value;
+
+  Window_entry *window_entry(uint n)
+  {
+    return window_queue + (window_queue_start + n) % window_queue_size;
+  }
+  bool add_as_window();
+  void clear_as_window();
+
   public:
   Item_sum_hybrid(THD *thd, Item *item_par,int sign):
     Item_sum(thd, item_par),
     Type_handler_hybrid_field_type(&type_handler_longlong),
     direct_added(FALSE), value(0), arg_cache(0), cmp(0),
-    cmp_sign(sign), was_values(TRUE)
+    cmp_sign(sign), was_values(TRUE), as_window_function(FALSE),
+    window_queue(0), window_queue_size(0)
   { collation.set(&my_charset_bin); }
   Item_sum_hybrid(THD *thd, Item_sum_hybrid *item)
     :Item_sum(thd, item),
     Type_handler_hybrid_field_type(item),
     direct_added(FALSE), value(item->value), arg_cache(0),
-    cmp_sign(item->cmp_sign), was_values(item->was_values)
+    cmp_sign(item->cmp_sign), was_values(item->was_values),
+    as_window_function(FALSE), window_queue(0), window_queue_size(0)
   { }
   bool fix_fields(THD *, Item **);
   bool fix_length_and_dec();
@@ -1091,6 +1163,12 @@ class Item_sum_hybrid :public Item_sum, public Type_handler_hybrid_field_type
   void restore_to_before_no_rows_in_result();
   Field *create_tmp_field(bool group, TABLE *table);
   void setup_caches(THD *thd) { setup_hybrid(thd, arguments()[0], NULL); }
+  void setup_window_func(THD *thd, Window_spec *window_spec);
+  bool supports_removal() const
+  {
+    return true;
+  }
+  void remove();
 };
 
 
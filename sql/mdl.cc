@@ -20,6 +20,7 @@
 #include "sql_array.h"
 #include "rpl_rli.h"
 #include <lf.h>
+#include <atomic>
 #include "unireg.h"
 #include <mysql/plugin.h>
 #include <mysql/service_thd_wait.h>
@@ -154,6 +155,8 @@ class MDL_map
   void init();
   void destroy();
   MDL_lock *find_or_insert(LF_PINS *pins, const MDL_key *key);
+  MDL_lock *try_acquire_fast_path(LF_PINS *pins, const MDL_key *key,
+                                  enum_mdl_type type);
   unsigned long get_lock_owner(LF_PINS *pins, const MDL_key *key);
   void remove(LF_PINS *pins, MDL_lock *lock);
   LF_PINS *get_pins() { return lf_hash_get_pins(&m_locks); }
@@ -324,6 +327,23 @@ class MDL_lock
 public:
   typedef mdl_bitmap_t bitmap_t;
 
+  /**
+    Type of MDL_lock::m_fast_path_state. Packs counters of "unobtrusive"
+    locks acquired on the fast path together with the flags below.
+  */
+  typedef uint64 fast_path_state_t;
+
+  /**
+    The object is being (or has been) removed from MDL_map and must not
+    be used for new fast path acquisitions.
+  */
+  static const fast_path_state_t IS_DESTROYED= 1ULL << 62;
+  /**
+    There are "obtrusive" tickets in the granted or waiting lists, or an
+    obtrusive request is being processed. Blocks the fast path.
+  */
+  static const fast_path_state_t HAS_OBTRUSIVE= 1ULL << 61;
+
   class Ticket_list
   {
   public:
@@ -367,6 +387,18 @@ class MDL_lock
     virtual bool needs_notification(const MDL_ticket *ticket) const = 0;
     virtual bool conflicting_locks(const MDL_ticket *ticket) const = 0;
     virtual bitmap_t hog_lock_types_bitmap() const = 0;
+    /**
+      Value by which a fast path counter in MDL_lock::m_fast_path_state is
+      incremented when a lock of this type is acquired, 0 for "obtrusive"
+      lock types which always use the granted and waiting lists.
+      All unobtrusive types must be compatible with each other.
+    */
+    virtual fast_path_state_t
+    unobtrusive_lock_increment(enum_mdl_type type) const = 0;
+    /** Maximum value of a single fast path counter. */
+    virtual fast_path_state_t fast_path_counter_max() const = 0;
+    /** Bitmap of lock types with non-zero fast path counters. */
+    virtual bitmap_t fast_path_granted_bitmap(fast_path_state_t state) const= 0;
     virtual ~MDL_lock_strategy() {}
   };
 
@@ -403,6 +435,15 @@ class MDL_lock
     */
     virtual bitmap_t hog_lock_types_bitmap() const
     { return 0; }
+
+    /* Scoped locks are rare enough to always use the lists. */
+    virtual fast_path_state_t
+    unobtrusive_lock_increment(enum_mdl_type type) const
+    { return 0; }
+    virtual fast_path_state_t fast_path_counter_max() const
+    { return 0; }
+    virtual bitmap_t fast_path_granted_bitmap(fast_path_state_t state) const
+    { return 0; }
   private:
     static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
     static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
@@ -451,6 +492,39 @@ class MDL_lock
               MDL_BIT(MDL_EXCLUSIVE));
     }
 
+    /**
+      S and SH locks share one counter, SR and SW locks (taken by DML)
+      have their own ones. 20 bits per counter.
+    */
+    virtual fast_path_state_t
+    unobtrusive_lock_increment(enum_mdl_type type) const
+    {
+      switch (type) {
+      case MDL_SHARED:
+      case MDL_SHARED_HIGH_PRIO:
+        return 1;
+      case MDL_SHARED_READ:
+        return 1ULL << 20;
+      case MDL_SHARED_WRITE:
+        return 1ULL << 40;
+      default:
+        return 0;
+      }
+    }
+    virtual fast_path_state_t fast_path_counter_max() const
+    { return (1ULL << 20) - 1; }
+    virtual bitmap_t fast_path_granted_bitmap(fast_path_state_t state) const
+    {
+      bitmap_t result= 0;
+      if (state & fast_path_counter_max())
+        result|= MDL_BIT(MDL_SHARED) | MDL_BIT(MDL_SHARED_HIGH_PRIO);
+      if (state & (fast_path_counter_max() << 20))
+        result|= MDL_BIT(MDL_SHARED_READ);
+      if (state & (fast_path_counter_max() << 40))
+        result|= MDL_BIT(MDL_SHARED_WRITE);
+      return result;
+    }
+
   private:
     static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
     static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
@@ -488,6 +562,48 @@ class MDL_lock
     */
     virtual bitmap_t hog_lock_types_bitmap() const
     { return 0; }
+
+    /**
+      Every statement changing data or metadata takes one of the DML,
+      DDL and COMMIT locks. TRANS_DML and ALTER_COPY conflict with
+      exactly the same lock types and share a counter. 12 bits per counter.
+    */
+    virtual fast_path_state_t
+    unobtrusive_lock_increment(enum_mdl_type type) const
+    {
+      switch (type) {
+      case MDL_BACKUP_DML:
+        return 1;
+      case MDL_BACKUP_TRANS_DML:
+      case MDL_BACKUP_ALTER_COPY:
+        return 1ULL << 12;
+      case MDL_BACKUP_SYS_DML:
+        return 1ULL << 24;
+      case MDL_BACKUP_DDL:
+        return 1ULL << 36;
+      case MDL_BACKUP_COMMIT:
+        return 1ULL << 48;
+      default:
+        return 0;
+      }
+    }
+    virtual fast_path_state_t fast_path_counter_max() const
+    { return (1ULL << 12) - 1; }
+    virtual bitmap_t fast_path_granted_bitmap(fast_path_state_t state) const
+    {
+      bitmap_t result= 0;
+      if (state & fast_path_counter_max())
+        result|= MDL_BIT(MDL_BACKUP_DML);
+      if (state & (fast_path_counter_max() << 12))
+        result|= MDL_BIT(MDL_BACKUP_TRANS_DML) | MDL_BIT(MDL_BACKUP_ALTER_COPY);
+      if (state & (fast_path_counter_max() << 24))
+        result|= MDL_BIT(MDL_BACKUP_SYS_DML);
+      if (state & (fast_path_counter_max() << 36))
+        result|= MDL_BIT(MDL_BACKUP_DDL);
+      if (state & (fast_path_counter_max() << 48))
+        result|= MDL_BIT(MDL_BACKUP_COMMIT);
+      return result;
+    }
   private:
     static const bitmap_t m_granted_incompatible[MDL_BACKUP_END];
     static const bitmap_t m_waiting_incompatible[MDL_BACKUP_END];
@@ -546,12 +662,53 @@ class MDL_lock
   bool can_grant_lock(enum_mdl_type type, MDL_context *requstor_ctx,
                       bool ignore_lock_priority) const;
 
+  static const MDL_lock_strategy *get_strategy(const MDL_key *key)
+  {
+    switch (key->mdl_namespace()) {
+    case MDL_key::BACKUP:
+      return &m_backup_lock_strategy;
+    case MDL_key::SCHEMA:
+      return &m_scoped_lock_strategy;
+    default:
+      return &m_object_lock_strategy;
+    }
+  }
+
+  static fast_path_state_t unobtrusive_lock_increment(const MDL_key *key,
+                                                      enum_mdl_type type)
+  { return get_strategy(key)->unobtrusive_lock_increment(type); }
+
+  bool is_obtrusive_lock(enum_mdl_type type) const
+  { return m_strategy->unobtrusive_lock_increment(type) == 0; }
+
+  bool fast_path_acquire(fast_path_state_t increment, bool *is_destroyed);
+  void fast_path_release(LF_PINS *pins, fast_path_state_t increment);
+
+  /**
+    Account for an obtrusive ticket being added to the granted or waiting
+    list. Must be called under write-locked m_rwlock.
+  */
+  void add_obtrusive_lock()
+  {
+    if (m_obtrusive_locks_granted_waiting_count++ == 0)
+      m_fast_path_state.fetch_or(HAS_OBTRUSIVE);
+  }
+  void remove_obtrusive_lock()
+  {
+    DBUG_ASSERT(m_obtrusive_locks_granted_waiting_count);
+    if (--m_obtrusive_locks_granted_waiting_count == 0)
+      m_fast_path_state.fetch_and(~HAS_OBTRUSIVE);
+  }
+
+  void unlock_or_destroy(LF_PINS *pins);
+
   inline unsigned long get_lock_owner() const;
 
   void reschedule_waiters();
 
   void remove_ticket(LF_PINS *pins, Ticket_list MDL_lock::*queue,
                      MDL_ticket *ticket);
+  void abandon_ticket(LF_PINS *pins, MDL_ticket *ticket);
 
   bool visit_subgraph(MDL_ticket *waiting_ticket,
                       MDL_wait_for_graph_visitor *gvisitor);
@@ -594,16 +751,37 @@ class MDL_lock
   */
   ulong m_hog_lock_count;
 
+  /**
+    Counters of granted unobtrusive locks which were acquired on the fast
+    path, i.e. without taking m_rwlock and without adding tickets to
+    m_granted, together with IS_DESTROYED and HAS_OBTRUSIVE flags.
+    The fast path is only available while HAS_OBTRUSIVE is not set.
+    Requests for obtrusive locks set it under m_rwlock before checking
+    if the lock can be granted, so that the counters can only decrease
+    while obtrusive tickets exist.
+  */
+  std::atomic<fast_path_state_t> m_fast_path_state;
+
+  /**
+    Number of obtrusive tickets in m_granted and m_waiting lists (plus
+    the pending request being processed). Protected by m_rwlock.
+  */
+  uint m_obtrusive_locks_granted_waiting_count;
+
 public:
 
   MDL_lock()
     : m_hog_lock_count(0),
+      m_fast_path_state(0),
+      m_obtrusive_locks_granted_waiting_count(0),
       m_strategy(0)
   { mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock); }
 
   MDL_lock(const MDL_key *key_arg)
   : key(key_arg),
     m_hog_lock_count(0),
+    m_fast_path_state(0),
+    m_obtrusive_locks_granted_waiting_count(0),
     m_strategy(&m_backup_lock_strategy)
   {
     DBUG_ASSERT(key_arg->mdl_namespace() == MDL_key::BACKUP);
@@ -624,10 +802,9 @@ class MDL_lock
   {
     DBUG_ASSERT(key_arg->mdl_namespace() != MDL_key::BACKUP);
     new (&lock->key) MDL_key(key_arg);
-    if (key_arg->mdl_namespace() == MDL_key::SCHEMA)
-      lock->m_strategy= &m_scoped_lock_strategy;
-    else
-      lock->m_strategy= &m_object_lock_strategy;
+    lock->m_fast_path_state= 0;
+    lock->m_obtrusive_locks_granted_waiting_count= 0;
+    lock->m_strategy= get_strategy(key_arg);
   }
 
   const MDL_lock_strategy *m_strategy;
@@ -727,6 +904,13 @@ static my_bool mdl_iterate_lock(MDL_lock *lock, mdl_iterate_arg *arg)
 }
 
 
+static my_bool mdl_materialize_fast_path_locks(THD *thd, void *)
+{
+  thd->mdl_context.materialize_fast_path_locks();
+  return FALSE;
+}
+
+
 int mdl_iterate(mdl_iterator_callback callback, void *arg)
 {
   DBUG_ENTER("mdl_iterate");
@@ -736,6 +920,12 @@ int mdl_iterate(mdl_iterator_callback callback, void *arg)
 
   if (pins)
   {
+    /*
+      Make locks acquired on the fast path visible in the granted lists.
+      Locks acquired after this point may be missed, same as locks
+      acquired after the iteration passed their MDL_lock object.
+    */
+    server_threads.iterate(mdl_materialize_fast_path_locks, (void *) 0);
     res= mdl_iterate_lock(mdl_locks.m_backup_lock, &argument) ||
          lf_hash_iterate(&mdl_locks.m_locks, pins,
                          (my_hash_walk_action) mdl_iterate_lock, &argument);
@@ -830,6 +1020,54 @@ MDL_lock* MDL_map::find_or_insert(LF_PINS *pins, const MDL_key *mdl_key)
 }
 
 
+/**
+  Try to acquire an unobtrusive lock on the fast path, see
+  MDL_lock::fast_path_acquire().
+
+  @retval non-NULL - The lock was acquired. MDL_lock instance for the key,
+                     m_rwlock is not locked.
+  @retval NULL     - The slow path must be used.
+*/
+
+MDL_lock *MDL_map::try_acquire_fast_path(LF_PINS *pins,
+                                         const MDL_key *mdl_key,
+                                         enum_mdl_type type)
+{
+  MDL_lock::fast_path_state_t increment=
+    MDL_lock::unobtrusive_lock_increment(mdl_key, type);
+  MDL_lock *lock;
+  bool is_destroyed= false;
+
+  if (!increment)
+    return NULL;
+
+  if (mdl_key->mdl_namespace() == MDL_key::BACKUP)
+  {
+    DBUG_ASSERT(mdl_key->length() == 3);
+    return m_backup_lock->fast_path_acquire(increment, &is_destroyed) ?
+           m_backup_lock : NULL;
+  }
+
+  do
+  {
+    while (!(lock= (MDL_lock*) lf_hash_search(&m_locks, pins, mdl_key->ptr(),
+                                              mdl_key->length())))
+      if (lf_hash_insert(&m_locks, pins, (uchar*) mdl_key) == -1)
+        return NULL;
+
+    is_destroyed= false;
+    if (lock->fast_path_acquire(increment, &is_destroyed))
+    {
+      lf_hash_search_unpin(pins);
+      return lock;
+    }
+    lf_hash_search_unpin(pins);
+  } while (is_destroyed);
+
+  return NULL;
+}
+
+
 /**
  * Return thread id of the owner of the lock, if it is owned.
  */
@@ -900,6 +1138,8 @@ MDL_context::MDL_context()
   m_pins(NULL)
 {
   mysql_prlock_init(key_MDL_context_LOCK_waiting_for, &m_LOCK_waiting_for);
+  /* Not registered in P_S: one more mutex per connection isn't worth it. */
+  mysql_mutex_init(0, &m_LOCK_fast_path, MY_MUTEX_INIT_FAST);
 }
 
 
@@ -920,8 +1160,10 @@ void MDL_context::destroy()
   DBUG_ASSERT(m_tickets[MDL_STATEMENT].is_empty());
   DBUG_ASSERT(m_tickets[MDL_TRANSACTION].is_empty());
   DBUG_ASSERT(m_tickets[MDL_EXPLICIT].is_empty());
+  DBUG_ASSERT(m_fast_path_tickets.is_empty());
 
   mysql_prlock_destroy(&m_LOCK_waiting_for);
+  mysql_mutex_destroy(&m_LOCK_fast_path);
   if (m_pins)
     lf_hash_put_pins(m_pins);
 }
@@ -1745,6 +1987,15 @@ MDL_lock::can_grant_lock(enum_mdl_type type_arg,
   if (!ignore_lock_priority && (m_waiting.bitmap() & waiting_incompat_map))
     return false;
 
+  /*
+    Locks acquired on the fast path always belong to other contexts:
+    the requestor materializes its own ones before asking for an
+    obtrusive lock, and unobtrusive locks are compatible with each other.
+  */
+  if (m_strategy->fast_path_granted_bitmap(m_fast_path_state) &
+      granted_incompat_map)
+    return false;
+
   if (m_granted.bitmap() & granted_incompat_map)
   {
     Ticket_iterator it(m_granted);
@@ -1802,6 +2053,112 @@ MDL_lock::get_lock_owner() const
 }
 
 
+/**
+  Unlock m_rwlock, destroying the lock object if nobody holds or
+  waits for it.
+
+  The object is considered unused if both lists are empty and there are
+  no locks acquired on the fast path. In this case IS_DESTROYED is set,
+  so that concurrent fast path acquisitions retry with a new object.
+*/
+
+void MDL_lock::unlock_or_destroy(LF_PINS *pins)
+{
+  fast_path_state_t unused= 0;
+
+  if (is_empty() && key.mdl_namespace() != MDL_key::BACKUP &&
+      m_fast_path_state.compare_exchange_strong(unused, IS_DESTROYED))
+    mdl_locks.remove(pins, this);
+  else
+    mysql_prlock_unlock(&m_rwlock);
+}
+
+
+/**
+  Drop a ticket for which MDL_context::try_acquire_lock_impl() has
+  failed to grant the lock and which was not added to the waiting
+  queue. Unlocks m_rwlock.
+*/
+
+void MDL_lock::abandon_ticket(LF_PINS *pins, MDL_ticket *ticket)
+{
+  if (is_obtrusive_lock(ticket->get_type()))
+    remove_obtrusive_lock();
+  unlock_or_destroy(pins);
+}
+
+
+/**
+  Try to acquire an unobtrusive lock without locking m_rwlock by
+  incrementing the corresponding counter in m_fast_path_state.
+
+  @param      increment     Value returned by unobtrusive_lock_increment().
+  @param[out] is_destroyed  Set to true if the object is being destroyed.
+
+  @retval true   The lock was acquired.
+  @retval false  Obtrusive locks exist, the counter is saturated or the
+                 object is being destroyed. The slow path must be used.
+*/
+
+bool MDL_lock::fast_path_acquire(fast_path_state_t increment,
+                                 bool *is_destroyed)
+{
+  /*
+    Don't use m_strategy here: it is reset when the object is being
+    destroyed. Both strategies with fast path support have counters
+    aligned to their width, so the counter mask is simply max * increment.
+  */
+  fast_path_state_t counter_mask=
+    increment * get_strategy(&key)->fast_path_counter_max();
+  fast_path_state_t old_state= m_fast_path_state.load(std::memory_order_relaxed);
+
+  do
+  {
+    if (old_state & IS_DESTROYED)
+    {
+      *is_destroyed= true;
+      return false;
+    }
+    if ((old_state & HAS_OBTRUSIVE) ||
+        (old_state & counter_mask) == counter_mask)
+      return false;
+  } while (!m_fast_path_state.compare_exchange_weak(old_state,
+                                                    old_state + increment));
+  return true;
+}
+
+
+/**
+  Release a lock acquired on the fast path.
+
+  If there are obtrusive requests waiting for the lock, they might be
+  granted now. If it was the last reference to the lock, the object
+  is destroyed.
+
+  @pre The caller has pinned the object with pin 3 of pins.
+*/
+
+void MDL_lock::fast_path_release(LF_PINS *pins, fast_path_state_t increment)
+{
+  fast_path_state_t old_state= m_fast_path_state.fetch_sub(increment);
+
+  DBUG_ASSERT(!(old_state & IS_DESTROYED));
+  if (old_state == increment || (old_state & HAS_OBTRUSIVE))
+  {
+    mysql_prlock_wrlock(&m_rwlock);
+    /* The object might have been destroyed by a concurrent release. */
+    if (!m_strategy)
+    {
+      mysql_prlock_unlock(&m_rwlock);
+      return;
+    }
+    if (!m_waiting.is_empty())
+      reschedule_waiters();
+    unlock_or_destroy(pins);
+  }
+}
+
+
 /** Remove a ticket from waiting or pending queue and wakeup up waiters. */
 
 void MDL_lock::remove_ticket(LF_PINS *pins, Ticket_list MDL_lock::*list,
@@ -1809,8 +2166,10 @@ void MDL_lock::remove_ticket(LF_PINS *pins, Ticket_list MDL_lock::*list,
 {
   mysql_prlock_wrlock(&m_rwlock);
   (this->*list).remove_ticket(ticket);
+  if (is_obtrusive_lock(ticket->get_type()))
+    remove_obtrusive_lock();
   if (is_empty())
-    mdl_locks.remove(pins, this);
+    unlock_or_destroy(pins);
   else
   {
     /*
@@ -2000,11 +2359,10 @@ MDL_context::try_acquire_lock(MDL_request *mdl_request)
     /*
       Our attempt to acquire lock without waiting has failed.
       Let us release resources which were acquired in the process.
-      We can't get here if we allocated a new lock object so there
-      is no need to release it.
+      The lock object might have been allocated for this request
+      if the conflicting locks were acquired on the fast path.
     */
-    DBUG_ASSERT(! ticket->m_lock->is_empty());
-    mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
+    ticket->m_lock->abandon_ticket(m_pins, ticket);
     MDL_ticket::destroy(ticket);
   }
 
@@ -2024,7 +2382,9 @@ MDL_context::try_acquire_lock(MDL_request *mdl_request)
                    lock exists. In this case "out_ticket" out parameter
                    points to ticket which was constructed for the request.
                    MDL_ticket::m_lock points to the corresponding MDL_lock
-                   object and MDL_lock::m_rwlock write-locked.
+                   object and MDL_lock::m_rwlock write-locked. The ticket
+                   must be either added to MDL_lock::m_waiting or dropped
+                   with MDL_lock::abandon_ticket().
   @retval  TRUE    Out of resources, an error has been reported.
 */
 
@@ -2088,6 +2448,38 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
                                    )))
     return TRUE;
 
+  /*
+    Unobtrusive locks (e.g. SR and SW locks taken by DML) are acquired
+    on the fast path if there are no obtrusive locks on the object.
+    Contexts which need to be notified about conflicting requests
+    can't use it, as such tickets are not in MDL_lock::m_granted.
+  */
+  if (!m_needs_thr_lock_abort && IF_WSREP(!WSREP_ON, true) &&
+      (lock= mdl_locks.try_acquire_fast_path(m_pins, key, mdl_request->type)))
+  {
+    ticket->m_lock= lock;
+    ticket->m_is_fast_path= true;
+
+    mysql_mutex_lock(&m_LOCK_fast_path);
+    m_fast_path_tickets.push_back(ticket);
+    mysql_mutex_unlock(&m_LOCK_fast_path);
+
+    m_tickets[mdl_request->duration].push_front(ticket);
+
+    mdl_request->ticket= ticket;
+    return FALSE;
+  }
+
+  bool is_obtrusive=
+    !MDL_lock::unobtrusive_lock_increment(key, mdl_request->type);
+
+  /*
+    Our own locks acquired on the fast path are invisible to
+    can_grant_lock() and to the deadlock detector.
+  */
+  if (is_obtrusive)
+    materialize_fast_path_locks();
+
   /* The below call implicitly locks MDL_lock::m_rwlock on success. */
   if (!(lock= mdl_locks.find_or_insert(m_pins, key)))
   {
@@ -2097,6 +2489,13 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
 
   ticket->m_lock= lock;
 
+  /*
+    Block the fast path before checking for conflicting locks,
+    so that they can't be acquired after the check.
+  */
+  if (is_obtrusive)
+    lock->add_obtrusive_lock();
+
   if (lock->can_grant_lock(mdl_request->type, this, false))
   {
     lock->m_granted.add_ticket(ticket);
@@ -2162,6 +2561,8 @@ MDL_context::clone_ticket(MDL_request *mdl_request)
   mdl_request->ticket= ticket;
 
   mysql_prlock_wrlock(&ticket->m_lock->m_rwlock);
+  if (ticket->m_lock->is_obtrusive_lock(ticket->m_type))
+    ticket->m_lock->add_obtrusive_lock();
   ticket->m_lock->m_granted.add_ticket(ticket);
   mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
 
@@ -2244,6 +2645,7 @@ MDL_context::acquire_lock(MDL_request *mdl_request, double lock_wait_timeout)
                                          mdl_request->type)->str,
                        lock_wait_timeout));
 
+retry:
   if (try_acquire_lock_impl(mdl_request, &ticket))
     DBUG_RETURN(TRUE);
 
@@ -2268,12 +2670,25 @@ MDL_context::acquire_lock(MDL_request *mdl_request, double lock_wait_timeout)
 
   if (lock_wait_timeout == 0)
   {
-    mysql_prlock_unlock(&lock->m_rwlock);
+    lock->abandon_ticket(m_pins, ticket);
     MDL_ticket::destroy(ticket);
     my_error(ER_LOCK_WAIT_TIMEOUT, MYF(0));
     DBUG_RETURN(TRUE);
   }
 
+  if (!m_fast_path_tickets.is_empty())
+  {
+    /*
+      Locks acquired on the fast path must be visible to the deadlock
+      detector before we start waiting. Moving them to the granted lists
+      requires other MDL_lock::m_rwlock's, so give up this attempt first.
+    */
+    lock->abandon_ticket(m_pins, ticket);
+    MDL_ticket::destroy(ticket);
+    materialize_fast_path_locks();
+    goto retry;
+  }
+
   lock->m_waiting.add_ticket(ticket);
 
   /*
@@ -2525,16 +2940,34 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
 
   is_new_ticket= ! has_lock(mdl_svp, mdl_xlock_request.ticket);
 
+  /*
+    Both tickets might have been acquired on the fast path if the new
+    type is unobtrusive (e.g. MDL_BACKUP_ALTER_COPY -> MDL_BACKUP_DDL).
+  */
+  materialize_fast_path_locks();
+
   /* Merge the acquired and the original lock. @todo: move to a method. */
   mysql_prlock_wrlock(&mdl_ticket->m_lock->m_rwlock);
+  /*
+    Account for the merged ticket before removing the old ones, so that
+    the fast path isn't unblocked in between.
+  */
+  if (mdl_ticket->m_lock->is_obtrusive_lock(new_type))
+    mdl_ticket->m_lock->add_obtrusive_lock();
   if (is_new_ticket)
+  {
     mdl_ticket->m_lock->m_granted.remove_ticket(mdl_xlock_request.ticket);
+    if (mdl_ticket->m_lock->is_obtrusive_lock(new_type))
+      mdl_ticket->m_lock->remove_obtrusive_lock();
+  }
   /*
     Set the new type of lock in the ticket. To update state of
     MDL_lock object correctly we need to temporarily exclude
     ticket from the granted queue and then include it back.
   */
   mdl_ticket->m_lock->m_granted.remove_ticket(mdl_ticket);
+  if (mdl_ticket->m_lock->is_obtrusive_lock(mdl_ticket->m_type))
+    mdl_ticket->m_lock->remove_obtrusive_lock();
   mdl_ticket->m_type= new_type;
   mdl_ticket->m_lock->m_granted.add_ticket(mdl_ticket);
 
@@ -2814,7 +3247,30 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
 
   DBUG_ASSERT(this == ticket->get_ctx());
 
-  lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
+  bool is_fast_path= ticket->m_is_fast_path;
+  if (is_fast_path)
+  {
+    /*
+      The ticket might have been materialized by mdl_iterate() meanwhile.
+      Otherwise remove it from the list before decrementing the counter,
+      after which the lock object might be destroyed.
+    */
+    mysql_mutex_lock(&m_LOCK_fast_path);
+    if ((is_fast_path= ticket->m_is_fast_path))
+      m_fast_path_tickets.remove(ticket);
+    mysql_mutex_unlock(&m_LOCK_fast_path);
+  }
+
+  if (is_fast_path)
+  {
+    lf_pin(m_pins, 3, lock);
+    lock->fast_path_release(m_pins,
+                            MDL_lock::unobtrusive_lock_increment(&lock->key,
+                                                                 ticket->m_type));
+    lf_unpin(m_pins, 3);
+  }
+  else
+    lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
 
   m_tickets[duration].remove(ticket);
   MDL_ticket::destroy(ticket);
@@ -2897,6 +3353,38 @@ void MDL_context::release_all_locks_for_name(MDL_ticket *name)
 }
 
 
+/**
+  Move tickets acquired on the fast path to the granted lists of
+  their locks.
+
+  This makes them visible to the deadlock detector, to
+  MDL_lock::notify_conflicting_locks() and to mdl_iterate(), and
+  allows them to be changed like any other granted ticket.
+
+  May be called by threads other than the owner of the context.
+
+  @note Must not be called while holding any MDL_lock::m_rwlock.
+*/
+
+void MDL_context::materialize_fast_path_locks()
+{
+  MDL_ticket *ticket;
+
+  mysql_mutex_lock(&m_LOCK_fast_path);
+  while ((ticket= m_fast_path_tickets.pop_front()))
+  {
+    MDL_lock *lock= ticket->m_lock;
+    mysql_prlock_wrlock(&lock->m_rwlock);
+    lock->m_granted.add_ticket(ticket);
+    lock->m_fast_path_state.fetch_sub(
+      MDL_lock::unobtrusive_lock_increment(&lock->key, ticket->m_type));
+    mysql_prlock_unlock(&lock->m_rwlock);
+    ticket->m_is_fast_path= false;
+  }
+  mysql_mutex_unlock(&m_LOCK_fast_path);
+}
+
+
 /**
   Downgrade an EXCLUSIVE or SHARED_NO_WRITE lock to shared metadata lock.
 
@@ -2923,12 +3411,20 @@ void MDL_ticket::downgrade_lock(enum_mdl_type type)
                (m_type == MDL_BACKUP_DDL ||
                 m_type == MDL_BACKUP_WAIT_FLUSH)));
 
+  /* MDL_BACKUP_DDL might have been acquired on the fast path. */
+  if (m_is_fast_path)
+    m_ctx->materialize_fast_path_locks();
+
   mysql_prlock_wrlock(&m_lock->m_rwlock);
   /*
     To update state of MDL_lock object correctly we need to temporarily
     exclude ticket from the granted queue and then include it back.
   */
+  if (m_lock->is_obtrusive_lock(type))
+    m_lock->add_obtrusive_lock();
   m_lock->m_granted.remove_ticket(this);
+  if (m_lock->is_obtrusive_lock(m_type))
+    m_lock->remove_obtrusive_lock();
   m_type= type;
   m_lock->m_granted.add_ticket(this);
   m_lock->reschedule_waiters();
@@ -675,7 +675,8 @@ class MDL_ticket : public MDL_wait_for_subgraph
   MDL_ticket **prev_in_context;
   /**
     Pointers for participating in the list of satisfied/pending requests
-    for the lock. Externally accessible.
+    for the lock, or in the context's list of locks acquired on the fast
+    path (see MDL_context::m_fast_path_tickets). Externally accessible.
   */
   MDL_ticket *next_in_lock;
   MDL_ticket **prev_in_lock;
@@ -721,7 +722,8 @@ class MDL_ticket : public MDL_wait_for_subgraph
      m_duration(duration_arg),
 #endif
      m_ctx(ctx_arg),
-     m_lock(NULL)
+     m_lock(NULL),
+     m_is_fast_path(false)
   {}
 
   static MDL_ticket *create(MDL_context *ctx_arg, enum_mdl_type type_arg
@@ -750,6 +752,14 @@ class MDL_ticket : public MDL_wait_for_subgraph
   */
   MDL_lock *m_lock;
 
+  /**
+    Indicates that the ticket was acquired on the "fast path", i.e. it is
+    accounted for in MDL_lock::m_fast_path_state rather than included in
+    the MDL_lock::m_granted list. Protected by
+    MDL_context::m_LOCK_fast_path, can only change from true to false.
+  */
+  bool m_is_fast_path;
+
 private:
   MDL_ticket(const MDL_ticket &);               /* not implemented */
   MDL_ticket &operator=(const MDL_ticket &);    /* not implemented */
@@ -918,11 +928,20 @@ class MDL_context
             will see the new value eventually.
     */
     m_needs_thr_lock_abort= needs_thr_lock_abort;
+    /*
+      Locks acquired on the fast path are not visible to
+      MDL_lock::notify_conflicting_locks(), move them to the
+      granted lists.
+    */
+    if (needs_thr_lock_abort)
+      materialize_fast_path_locks();
   }
   bool get_needs_thr_lock_abort() const
   {
     return m_needs_thr_lock_abort;
   }
+
+  void materialize_fast_path_locks();
 public:
   /**
     If our request for a lock is scheduled, or aborted by the deadlock
@@ -1014,6 +1033,25 @@ class MDL_context
    */
   MDL_wait_for_subgraph *m_waiting_for;
   LF_PINS *m_pins;
+
+  typedef I_P_List<MDL_ticket,
+                   I_P_List_adapter<MDL_ticket,
+                                    &MDL_ticket::next_in_lock,
+                                    &MDL_ticket::prev_in_lock>,
+                   I_P_List_null_counter,
+                   I_P_List_fast_push_back<MDL_ticket> >
+          Fast_path_ticket_list;
+
+  /**
+    Granted tickets which were acquired on the fast path and thus are
+    not included in MDL_lock::m_granted lists, in the order of their
+    acquisition. Tickets are added only
+    by the owner of the context, but other threads may move them to
+    the granted lists (see mdl_iterate()).
+  */
+  Fast_path_ticket_list m_fast_path_tickets;
+  /** Mutex protecting m_fast_path_tickets. */
+  mysql_mutex_t m_LOCK_fast_path;
 private:
   MDL_ticket *find_ticket(MDL_request *mdl_req,
                           enum_mdl_duration *duration);
@@ -574,6 +574,8 @@ int Mrr_ordered_index_reader::init(handler *h_arg, RANGE_SEQ_IF *seq_funcs,
   source_exhausted= FALSE;
   read_was_interrupted= false;
   have_saved_rowid= FALSE;
+  /* Let the engine know that the keys are looked up in ascending order */
+  file->extra(HA_EXTRA_SORTED_KEY_LOOKUPS);
   return 0;
 }
 
@@ -595,6 +597,8 @@ int Mrr_ordered_rndpos_reader::init(handler *h_arg,
   is_mrr_assoc= !MY_TEST(mode & HA_MRR_NO_ASSOCIATION);
   index_reader_exhausted= FALSE;
   index_reader_needs_refill= TRUE;
+  /* Let the engine know that the rowids are looked up in ascending order */
+  file->extra(HA_EXTRA_SORTED_KEY_LOOKUPS);
   return 0;
 }
 
@@ -367,6 +367,9 @@ char *gtid_pos_auto_engines;
 plugin_ref *opt_gtid_pos_auto_plugins;
 static char compiled_default_collation_name[]= MYSQL_DEFAULT_COLLATION_NAME;
 static I_List<CONNECT> thread_cache;
+/* THD objects of closed pool-of-threads connections, see cache_thd() */
+static I_List<THD> thd_cache;
+static ulong cached_thd_count= 0;
 static bool binlog_format_used= false;
 LEX_STRING opt_init_connect, opt_init_slave;
 mysql_cond_t COND_thread_cache;
@@ -466,6 +469,7 @@ uint protocol_version;
 uint lower_case_table_names;
 ulong tc_heuristic_recover= 0;
 Atomic_counter<uint32_t> thread_count;
+Atomic_counter<uint32_t> digest_consumers;
 int32 slave_open_temp_tables;
 ulong thread_created;
 ulong back_log, connect_timeout, concurrency, server_id;
@@ -2775,8 +2779,67 @@ bool one_thread_per_connection_end(THD *thd, bool put_in_cache)
 }
 
 
+/*
+  Store THD of a closed connection in cache for reuse by new connections
+
+  SYNOPSIS
+    cache_thd()
+    thd		 Thread handler, unlinked by unlink_thd()
+
+  NOTES
+    Used by the thread pool. Its connections are not bound to threads,
+    so THD objects are cached instead of threads: up to thread_cache_size
+    of them. The caller must have detached thd from the current thread.
+
+    LOCK_thread_cache is used to protect the cache variables
+
+  RETURN
+    0  THD was not put in cache, caller should delete it
+    1  THD is cached, get_cached_thd() will return it
+*/
+
+bool cache_thd(THD *thd)
+{
+  bool cached= 0;
+  DBUG_ENTER("cache_thd");
+
+  mysql_mutex_lock(&LOCK_thread_cache);
+  if (cached_thd_count < thread_cache_size &&
+      ! abort_loop && !kill_cached_threads)
+  {
+    thd_cache.append(thd);                      // Reuse most recent first
+    cached_thd_count++;
+    cached= 1;
+  }
+  mysql_mutex_unlock(&LOCK_thread_cache);
+  DBUG_RETURN(cached);
+}
+
+
+/*
+  Get THD stored by cache_thd(), to be passed to CONNECT::create_thd()
+
+  RETURN
+    0    Cache is empty
+    #    THD to reuse
+*/
+
+THD *get_cached_thd()
+{
+  THD *thd;
+
+  mysql_mutex_lock(&LOCK_thread_cache);
+  if ((thd= thd_cache.get()))
+    cached_thd_count--;
+  mysql_mutex_unlock(&LOCK_thread_cache);
+  return thd;
+}
+
+
 void flush_thread_cache()
 {
+  I_List<THD> thds;
+  THD *thd;
   DBUG_ENTER("flush_thread_cache");
   mysql_mutex_lock(&LOCK_thread_cache);
   kill_cached_threads++;
@@ -2786,7 +2849,14 @@ void flush_thread_cache()
     mysql_cond_wait(&COND_flush_thread_cache, &LOCK_thread_cache);
   }
   kill_cached_threads--;
+  while ((thd= thd_cache.get()))
+    thds.push_back(thd);
+  cached_thd_count= 0;
   mysql_mutex_unlock(&LOCK_thread_cache);
+
+  /* Keep out of locked LOCK_thread_cache */
+  while ((thd= thds.get()))
+    delete thd;
   DBUG_VOID_RETURN;
 }
 
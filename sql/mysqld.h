@@ -89,6 +89,8 @@ void create_thread_to_handle_connection(CONNECT *connect);
 void unlink_thd(THD *thd);
 bool one_thread_per_connection_end(THD *thd, bool put_in_cache);
 void flush_thread_cache();
+bool cache_thd(THD *thd);
+THD *get_cached_thd();
 void refresh_status(THD *thd);
 bool is_secure_file_path(char *path);
 void dec_connection_count(scheduler_functions *scheduler);
@@ -643,6 +645,8 @@ extern mysql_cond_t COND_thread_count, COND_start_thread;
 extern mysql_cond_t COND_manager;
 extern mysql_cond_t COND_slave_background;
 extern Atomic_counter<uint32_t> thread_count;
+/* Number of plugins which need statement digests, see parse_sql() */
+extern MYSQL_PLUGIN_IMPORT Atomic_counter<uint32_t> digest_consumers;
 
 extern char *opt_ssl_ca, *opt_ssl_capath, *opt_ssl_cert, *opt_ssl_cipher,
   *opt_ssl_key, *opt_ssl_crl, *opt_ssl_crlpath;
@@ -8489,6 +8489,102 @@ sel_add(SEL_ARG *key1,SEL_ARG *key2)
 }
 
 
+/*
+  Get the weight of a SEL_ARG graph
+
+  SYNOPSIS
+    get_sel_arg_weight()
+      tree            The root of the graph
+      limit           Stop counting when the weight exceeds this number
+
+  DESCRIPTION
+    The weight is the number of intervals in the graph where an interval
+    is counted once for every path from the root that leads to it through
+    the next_key_part links. This is the number of ranges that will be
+    enumerated for the graph when the cost of a range scan is calculated.
+    The next_key_part graphs are shared by the intervals of the previous
+    key part, so the weight can grow as the product of the numbers of
+    intervals on each key part while the number of SEL_ARG objects grows
+    as their sum.
+
+  RETURN
+    The weight, or a number greater than limit if the weight exceeds it
+*/
+
+static ulonglong get_sel_arg_weight(SEL_ARG *tree, ulonglong limit)
+{
+  ulonglong weight= 0;
+  if (tree->type != SEL_ARG::KEY_RANGE)
+    return 0;
+  for (SEL_ARG *arg= tree->first(); arg && weight <= limit; arg= arg->next)
+  {
+    weight++;
+    if (arg->next_key_part && weight <= limit)
+      weight+= get_sel_arg_weight(arg->next_key_part, limit - weight);
+  }
+  return weight;
+}
+
+
+/*
+  Remove the intervals over the key parts starting from max_part from a
+  SEL_ARG graph. The remaining intervals do not depend on the values of
+  the removed key parts any more, so the graph describes a superset of
+  the rows it described before.
+*/
+
+static void prune_sel_arg_graph(SEL_ARG *tree, uint max_part)
+{
+  if (tree->type != SEL_ARG::KEY_RANGE)
+    return;
+  for (SEL_ARG *arg= tree->first(); arg; arg= arg->next)
+  {
+    if (!arg->next_key_part)
+      continue;
+    if (arg->next_key_part->part >= max_part)
+      arg->next_key_part= NULL;
+    else
+      prune_sel_arg_graph(arg->next_key_part, max_part);
+  }
+}
+
+
+/*
+  Keep the weight of a SEL_ARG graph within optimizer_max_sel_arg_weight
+
+  SYNOPSIS
+    enforce_sel_arg_weight_limit()
+      param           Context info for the operation
+      tree            The root of the graph built for an index
+
+  DESCRIPTION
+    Conjunctions of IN lists over several key parts produce graphs whose
+    weight (see get_sel_arg_weight()) is the product of the lengths of the
+    lists. Enumerating so many ranges takes a lot of time and memory, and
+    many index dives. If the weight exceeds optimizer_max_sel_arg_weight
+    the intervals over the last key part are removed from the graph one key
+    part after another until the weight is within the limit. The ranges
+    become coarser, and the rest of the condition is checked for the rows
+    read from them. The intervals over the first key part are always kept.
+*/
+
+static void enforce_sel_arg_weight_limit(RANGE_OPT_PARAM *param,
+                                         SEL_ARG *tree)
+{
+  ulonglong limit= param->thd->variables.optimizer_max_sel_arg_weight;
+  if (!limit || !tree || tree->type != SEL_ARG::KEY_RANGE)
+    return;
+
+  while (tree->max_part_no > tree->part + 1 &&
+         get_sel_arg_weight(tree, limit) > limit)
+  {
+    uint max_part= tree->max_part_no - 1;
+    prune_sel_arg_graph(tree, max_part);
+    tree->max_part_no= max_part;
+  }
+}
+
+
 /* 
   Build a range tree for the conjunction of the range parts of two trees
 
@@ -8558,6 +8654,7 @@ int and_range_trees(RANGE_OPT_PARAM *param, SEL_TREE *tree1, SEL_TREE *tree2,
 	result->type= SEL_TREE::IMPOSSIBLE;
         DBUG_RETURN(1);
       }
+      enforce_sel_arg_weight_limit(param, key);
       result_keys.set_bit(key_no);
 #ifdef EXTRA_DEBUG
       if (param->alloced_sel_args < SEL_ARG::MAX_SEL_ARGS) 
@@ -9090,7 +9187,10 @@ tree_or(RANGE_OPT_PARAM *param,SEL_TREE *tree1,SEL_TREE *tree2)
         key2->incr_refs();
       }
       if ((result->keys[key_no]= key_or(param, key1, key2)))
+      {
         result->keys_map.set_bit(key_no);
+        enforce_sel_arg_weight_limit(param, result->keys[key_no]);
+      }
     }
     result->type= tree1->type;
   }
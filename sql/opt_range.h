@@ -264,6 +264,8 @@ class SEL_ARG :public Sql_alloc
   enum Type { IMPOSSIBLE, MAYBE, MAYBE_KEY, KEY_RANGE } type;
 
   enum { MAX_SEL_ARGS = 16000 };
+  /* Default of optimizer_max_sel_arg_weight */
+  enum { MAX_WEIGHT = 32000 };
 
   SEL_ARG() {}
   SEL_ARG(SEL_ARG &);
@@ -187,6 +187,7 @@
 
 #include "mariadb.h"
 #include "sql_select.h"
+#include "sql_cte.h"
 
 /* Info on a splitting field */
 struct SplM_field_info
@@ -698,7 +699,8 @@ void JOIN::add_keyuses_for_splitting()
   double oper_cost;
   uint rec_len;
   uint added_keyuse_count;
-  TABLE *table= select_lex->master_unit()->derived->table;
+  TABLE_LIST *derived= select_lex->master_unit()->derived;
+  TABLE *table= derived->table;
   List_iterator_fast<KEY_FIELD> li(spl_opt_info->added_key_fields);
   KEY_FIELD *added_key_field;
   if (!spl_opt_info->added_key_fields.elements)
@@ -726,6 +728,13 @@ void JOIN::add_keyuses_for_splitting()
 
   spl_opt_info->unsplit_cost= best_positions[table_count-1].read_time +
                               oper_cost;
+  /*
+    If the table is a reference to a CTE whose materialization is shared
+    by all its references only a part of the cost of materialization
+    is to be attributed to this reference
+  */
+  if (derived->can_share_materialization())
+    spl_opt_info->unsplit_cost/= derived->with->get_references();
 
   if (!(save_qep= new Join_plan_state(table_count + 1)))
     goto err;
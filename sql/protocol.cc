@@ -199,6 +199,8 @@ bool net_send_error(THD *thd, uint sql_errno, const char *err,
   @param id		   Auto_increment id for first row (if used)
   @param message	   Message to send to the client (Used by mysql_status)
   @param is_eof            this called instead of old EOF packet
+  @param skip_flush        do not flush, more results of the same COM_MULTI
+                           follow
 
   @return
     @retval FALSE The message was successfully sent
@@ -285,7 +287,7 @@ net_send_ok(THD *thd,
   DBUG_ASSERT(store.length() <= MAX_PACKET_LENGTH);
 
   error= my_net_write(net, (const unsigned char*)store.ptr(), store.length());
-  if (likely(!error) && (!skip_flush || is_eof))
+  if (likely(!error) && !skip_flush)
     error= net_flush(net);
 
   thd->server_status&= ~SERVER_SESSION_STATE_CHANGED;
@@ -327,6 +329,12 @@ net_send_eof(THD *thd, uint server_status, uint statement_warn_count)
 {
   NET *net= &thd->net;
   bool error= FALSE;
+  /*
+    A result set of a COM_MULTI command that is followed by other
+    commands of the batch is sent together with their results.
+  */
+  bool skip_flush= (thd->get_stmt_da()->is_eof() &&
+                    thd->get_stmt_da()->skip_flush());
   DBUG_ENTER("net_send_eof");
 
   /*
@@ -340,7 +348,7 @@ net_send_eof(THD *thd, uint server_status, uint statement_warn_count)
       (thd->get_command() != COM_BINLOG_DUMP ))
   {
     error= net_send_ok(thd, server_status, statement_warn_count, 0, 0, NULL,
-                       true, false);
+                       true, skip_flush);
     DBUG_RETURN(error);
   }
 
@@ -349,7 +357,7 @@ net_send_eof(THD *thd, uint server_status, uint statement_warn_count)
   {
     thd->get_stmt_da()->set_overwrite_status(true);
     error= write_eof_packet(thd, net, server_status, statement_warn_count);
-    if (likely(!error))
+    if (likely(!error) && !skip_flush)
       error= net_flush(net);
     thd->get_stmt_da()->set_overwrite_status(false);
     DBUG_PRINT("info", ("EOF sent, so no more error sending allowed"));
@@ -970,9 +978,66 @@ bool Protocol::send_result_set_metadata(List<Item> *list, uint flags)
 bool Protocol::write()
 {
   DBUG_ENTER("Protocol::write");
+  if (packet == &net_row)
+  {
+    NET *net= &thd->net;
+    size_t length= net_row.length();
+    packet= &thd->packet;
+    /*
+      Unless the row did not fit and was moved to the heap, it is in
+      place already and only needs its packet header.
+    */
+    if (net_row.ptr() == (char*) net->write_pos + NET_HEADER_SIZE)
+    {
+      int3store(net->write_pos, length);
+      net->write_pos[3]= (uchar) net->pkt_nr++;
+      net->write_pos+= NET_HEADER_SIZE + length;
+      DBUG_RETURN(FALSE);
+    }
+    DBUG_RETURN(my_net_write(net, (uchar*) net_row.ptr(), length));
+  }
   DBUG_RETURN(my_net_write(&thd->net, (uchar*) packet->ptr(),
                            packet->length()));
 }
+
+
+/**
+  Store the next row directly into the network buffer.
+
+  Normally a row is stored into thd->packet, and write() copies it into
+  the network buffer. If the free space of the buffer is big enough, the
+  row is stored there after room for the packet header instead, and
+  write() only adds the header. A row that does not fit is moved to the
+  heap by String::realloc() and is written the usual way.
+
+  Must be called before prepare_for_resend(). The row must be finished
+  by write() or abandoned by remove_last_row(), and nothing else may be
+  written to the network in between.
+*/
+
+void Protocol::remove_last_row()
+{
+  packet= &thd->packet;
+}
+
+
+void Protocol::store_in_net_buffer()
+{
+  NET *net= &thd->net;
+  size_t left;
+  DBUG_ASSERT(packet == &thd->packet);
+  /* Protocol_local and Protocol_discard do not write to the network */
+  if (!net->vio || net->compress ||
+      (this != &thd->protocol_text && this != &thd->protocol_binary))
+    return;
+  left= net->buff_end - net->write_pos;
+  /* Leave a nearly full buffer to my_net_write() */
+  if (left < NET_HEADER_SIZE + MAX_FIELD_WIDTH + field_count / 8 + 2)
+    return;
+  net_row.set_alloced((char*) net->write_pos + NET_HEADER_SIZE, 0,
+                      MY_MIN(left - NET_HEADER_SIZE, MAX_PACKET_LENGTH - 1));
+  packet= &net_row;
+}
 #endif /* EMBEDDED_LIBRARY */
 
 
@@ -42,6 +42,8 @@ class Protocol
 #endif
   uint field_count;
 #ifndef EMBEDDED_LIBRARY
+  /* The free space of the network buffer, see store_in_net_buffer() */
+  String net_row;
   bool net_store_data(const uchar *from, size_t length);
   bool net_store_data_cs(const uchar *from, size_t length,
                       CHARSET_INFO *fromcs, CHARSET_INFO *tocs);
@@ -124,8 +126,10 @@ class Protocol
 #ifdef EMBEDDED_LIBRARY
   int begin_dataset();
   virtual void remove_last_row() {}
+  void store_in_net_buffer() {}
 #else
-  void remove_last_row() {}
+  void remove_last_row();
+  void store_in_net_buffer();
 #endif
   enum enum_protocol_type
   {
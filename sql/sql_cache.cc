@@ -1291,6 +1291,7 @@ Query_cache::Query_cache(size_t query_cache_limit_arg,
   set_if_bigger(min_allocation_unit,min_needed);
   this->min_allocation_unit= ALIGN_SIZE(min_allocation_unit);
   set_if_bigger(this->min_result_data_size,min_allocation_unit);
+  clear_table_filter();
 }
 
 
@@ -2589,6 +2590,36 @@ void Query_cache::init()
 }
 
 
+/*
+  Collation of the db and table names in the tables hash
+*/
+
+static CHARSET_INFO *query_cache_table_charset()
+{
+#ifndef FN_NO_CASE_SENSE
+  /*
+    If lower_case_table_names!=0 then db and table names are already 
+    converted to lower case and we can use binary collation for their 
+    comparison (no matter if file system case sensitive or not).
+    If we have case-sensitive file system (like on most Unixes) and
+    lower_case_table_names == 0 then we should distinguish my_table
+    and MY_TABLE cases and so again can use binary collation.
+  */
+  return &my_charset_bin;
+#else
+  /*
+    On windows, OS/2, MacOS X with HFS+ or any other case insensitive
+    file system if lower_case_table_names!=0 we have same situation as
+    in previous case, but if lower_case_table_names==0 then we should
+    not distinguish cases (to be compatible in behavior with underlying
+    file system) and so should use case insensitive collation for
+    comparison.
+  */
+  return lower_case_table_names ? &my_charset_bin : files_charset_info;
+#endif
+}
+
+
 size_t Query_cache::init_cache()
 {
   size_t mem_bin_count, num, step;
@@ -2732,32 +2763,10 @@ size_t Query_cache::init_cache()
 
   (void) my_hash_init(&queries, &my_charset_bin, def_query_hash_size, 0, 0,
                       query_cache_query_get_key, 0, 0);
-#ifndef FN_NO_CASE_SENSE
-  /*
-    If lower_case_table_names!=0 then db and table names are already 
-    converted to lower case and we can use binary collation for their 
-    comparison (no matter if file system case sensitive or not).
-    If we have case-sensitive file system (like on most Unixes) and
-    lower_case_table_names == 0 then we should distinguish my_table
-    and MY_TABLE cases and so again can use binary collation.
-  */
-  (void) my_hash_init(&tables, &my_charset_bin, def_table_hash_size, 0, 0,
-                      query_cache_table_get_key, 0, 0);
-#else
-  /*
-    On windows, OS/2, MacOS X with HFS+ or any other case insensitive
-    file system if lower_case_table_names!=0 we have same situation as
-    in previous case, but if lower_case_table_names==0 then we should
-    not distinguish cases (to be compatible in behavior with underlying
-    file system) and so should use case insensitive collation for
-    comparison.
-  */
-  (void) my_hash_init(&tables,
-                      lower_case_table_names ? &my_charset_bin :
-                      files_charset_info,
-                      def_table_hash_size, 0, 0,query_cache_table_get_key,
+  (void) my_hash_init(&tables, query_cache_table_charset(),
+                      def_table_hash_size, 0, 0, query_cache_table_get_key,
                       0, 0);
-#endif
+  clear_table_filter();
 
   queries_in_cache = 0;
   queries_blocks = 0;
@@ -2838,6 +2847,7 @@ void Query_cache::free_cache()
   make_disabled();
   my_hash_free(&queries);
   my_hash_free(&tables);
+  clear_table_filter();
   DBUG_VOID_RETURN;
 }
 
@@ -3305,6 +3315,10 @@ void Query_cache::invalidate_table(THD *thd, TABLE *table)
 
 void Query_cache::invalidate_table(THD *thd, uchar * key, size_t key_length)
 {
+  /* Nothing to invalidate if no query using the table is cached */
+  if (!is_in_table_filter(key, key_length))
+    return;
+
   DEBUG_SYNC(thd, "wait_in_query_cache_invalidate1");
 
   /*
@@ -3569,6 +3583,8 @@ Query_cache::insert_table(THD *thd, size_t key_len, const char *key,
       free_memory_block(table_block);
       DBUG_RETURN(0);
     }
+    if (hash)
+      add_to_table_filter(key, key_len);
     char *db= header->db();
     header->table(db + db_length + 1);
     header->key_length((uint32)key_len);
@@ -3632,12 +3648,75 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
                                &tables_blocks);
     Query_cache_table *header= table_block->table();
     if (header->is_hashed())
+    {
       my_hash_delete(&tables,(uchar *) table_block);
+      if (!tables.records)
+        clear_table_filter();
+    }
     free_memory_block(table_block);
   }
   DBUG_VOID_RETURN;
 }
 
+
+/*
+  Filter of the tables that may have cached queries
+
+  The filter lets a table be invalidated without locking the query cache
+  when no queries using it are cached, which is the common case for
+  writes to tables that are not read through the cache. A false positive
+  only means that the cache is locked and the table is searched in the
+  tables hash as before.
+
+  Adding a table and checking it are ordered by the atomic operations on
+  the bit the same way they are ordered by the lock: if an invalidation
+  doesn't see the bit, the table was registered after the invalidation.
+*/
+
+static inline uint table_filter_bit(const uchar *key, size_t key_length)
+{
+  return my_hash_sort(query_cache_table_charset(), key, key_length) %
+         QUERY_CACHE_TABLE_FILTER_BITS;
+}
+
+
+/**
+  Add a table to the filter of tables with cached queries.
+
+  @pre structure_guard_mutex is acquired or LOCKED is set.
+*/
+
+void Query_cache::add_to_table_filter(const char *key, size_t key_length)
+{
+  uint bit= table_filter_bit((const uchar*) key, key_length);
+  uint32 *word= table_filter + bit / 32;
+  uint32 mask= (uint32) 1 << (bit % 32);
+  uint32 value= my_atomic_load32((int32*) word);
+  if (!(value & mask))
+    my_atomic_store32((int32*) word, (int32) (value | mask));
+}
+
+
+bool Query_cache::is_in_table_filter(const uchar *key, size_t key_length)
+{
+  uint bit= table_filter_bit(key, key_length);
+  return ((uint32) my_atomic_load32((int32*) (table_filter + bit / 32)) >>
+          (bit % 32)) & 1;
+}
+
+
+/**
+  Clear the filter, there are no tables in the tables hash.
+
+  @pre structure_guard_mutex is acquired or LOCKED is set.
+*/
+
+void Query_cache::clear_table_filter()
+{
+  for (uint i= 0; i < array_elements(table_filter); i++)
+    my_atomic_store32((int32*) (table_filter + i), 0);
+}
+
 /*****************************************************************************
   Free memory management
 *****************************************************************************/
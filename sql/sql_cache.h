@@ -40,6 +40,9 @@ typedef struct st_changed_table_list CHANGED_TABLE_LIST;
 #define QUERY_CACHE_DEF_QUERY_HASH_SIZE		1024
 #define QUERY_CACHE_DEF_TABLE_HASH_SIZE		1024
 
+/* number of bits in the filter of tables with cached queries */
+#define QUERY_CACHE_TABLE_FILTER_BITS		4096
+
 /* minimal result data size when data allocated */
 #define QUERY_CACHE_MIN_RESULT_DATA_SIZE	(1024*4)
 
@@ -346,6 +349,13 @@ class Query_cache
   Query_cache_memory_bin *bins;			// free block lists
   Query_cache_memory_bin_step *steps;		// bins spacing info
   HASH queries, tables;
+  /*
+    One bit per hash value of the keys in the tables hash. A table whose
+    bit is not set has no cached queries, and its invalidation doesn't
+    need to lock the cache. The bits are set under structure_guard_mutex,
+    read without it, and only cleared when the tables hash gets empty.
+  */
+  uint32 table_filter[QUERY_CACHE_TABLE_FILTER_BITS / 32];
   /* options */
   size_t min_allocation_unit, min_result_data_size;
   uint def_query_hash_size, def_table_hash_size;
@@ -386,6 +396,9 @@ class Query_cache
 			      TABLE_LIST *tables_used,
 			      TABLE_COUNTER_TYPE tables);
   void unlink_table(Query_cache_block_table *node);
+  void add_to_table_filter(const char *key, size_t key_length);
+  bool is_in_table_filter(const uchar *key, size_t key_length);
+  void clear_table_filter();
   Query_cache_block *get_free_block (size_t len, my_bool not_less,
 				      size_t min);
   void free_memory_block(Query_cache_block *point);
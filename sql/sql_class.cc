@@ -63,6 +63,7 @@
 #include "sql_select.h" /* declares create_tmp_table() */
 #include "debug_sync.h"
 #include "sql_parse.h"                          // is_update_query
+#include "sql_prepare.h"                        // auto_param_cache_free
 #include "sql_callback.h"
 #include "lock.h"
 #include "wsrep_mysqld.h"
@@ -844,6 +845,7 @@ THD::THD(my_thread_id id, bool is_wsrep_applier, bool skip_global_sys_var_lock)
   my_rnd_init(&rand, tmp + (ulong)((size_t) &rand), tmp + (ulong) ::global_query_id);
   substitute_null_with_insert_id = FALSE;
   lock_info.mysql_thd= (void *)this;
+  auto_param_cache= NULL;
 
   m_token_array= NULL;
   if (max_digest_length > 0)
@@ -1399,6 +1401,7 @@ void THD::change_user(void)
 
   init();
   stmt_map.reset();
+  auto_param_cache_free(this);
   my_hash_init(&user_vars, system_charset_info, USER_VARS_HASH_SIZE, 0, 0,
                (my_hash_get_key) get_var_key,
                (my_hash_free_key) free_user_var, 0);
@@ -1553,6 +1556,7 @@ void THD::cleanup(void)
 
   mysql_ull_cleanup(this);
   stmt_map.reset();
+  auto_param_cache_free(this);
   /* All metadata locks must have been released by now. */
   DBUG_ASSERT(!mdl_context.has_locks());
 
@@ -1588,6 +1592,7 @@ void THD::free_connection()
   main_security_ctx.destroy();
   /* close all prepared statements, to save memory */
   stmt_map.reset();
+  auto_param_cache_free(this);
   free_connection_done= 1;
 #if defined(ENABLED_PROFILING)
   profiling.restart();                          // Reset profiling
@@ -2978,6 +2983,7 @@ int select_send::send_data(List<Item> &items)
   if (thd->killed == ABORT_QUERY)
     DBUG_RETURN(FALSE);
 
+  protocol->store_in_net_buffer();
   protocol->prepare_for_resend();
   if (protocol->send_result_set_row(&items))
   {
@@ -595,6 +595,7 @@ typedef struct system_variables
   ha_rows max_join_size;
   ha_rows expensive_subquery_limit;
   ulong auto_increment_increment, auto_increment_offset;
+  ulong auto_parameterize_cache_size;
   uint eq_range_index_dive_limit;
   ulong column_compression_zlib_strategy;
   ulong lock_wait_timeout;
@@ -614,6 +615,7 @@ typedef struct system_variables
   ulong net_retry_count;
   ulong net_wait_timeout;
   ulong net_write_timeout;
+  ulong optimizer_max_sel_arg_weight;
   ulong optimizer_prune_level;
   ulong optimizer_search_depth;
   ulong optimizer_selectivity_sampling_limit;
@@ -621,6 +623,7 @@ typedef struct system_variables
   ulong use_stat_tables;
   ulong histogram_size;
   ulong histogram_type;
+  double sample_percentage;
   ulong preload_buff_size;
   ulong profiling_history_size;
   ulong read_buff_size;
@@ -674,6 +677,7 @@ typedef struct system_variables
   my_bool old_passwords;
   my_bool big_tables;
   my_bool only_standard_compliant_cte;
+  my_bool optimizer_reuse_join_order;
   my_bool query_cache_strip_comments;
   my_bool sql_log_slow;
   my_bool sql_log_bin;
@@ -2274,6 +2278,9 @@ class THD: public THD_count, /* this must be first */
   /* all prepared statements and cursors of this connection */
   Statement_map stmt_map;
 
+  /* auto-parameterized client statements, see sql_prepare.cc */
+  class Auto_param_cache *auto_param_cache;
+
   /* Last created prepared statement */
   Statement *last_stmt;
   inline void set_last_stmt(Statement *stmt)
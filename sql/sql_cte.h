@@ -157,6 +157,15 @@ class With_element : public Sql_alloc
   */
   select_union_recursive *rec_result;
 
+  /*
+    The object used to keep the rows of this non-recursive with element
+    after they have been materialized for one of its references. Other
+    references whose specification has not been changed by the optimizer
+    copy the rows from its table instead of executing their specifications.
+    It is set at the execution stage.
+  */
+  select_unit *shared_result;
+
   /* List of Item_subselects containing recursive references to this CTE */
   SQL_I_List<Item_subselect> sq_with_rec_ref;
   /* List of derived tables containing recursive references to this CTE */
@@ -171,7 +180,7 @@ class With_element : public Sql_alloc
       next_mutually_recursive(NULL), references(0), 
       query_name(name), column_list(list), spec(unit),
       is_recursive(false), rec_outer_references(0), with_anchor(false),
-      level(0), rec_result(NULL)
+      level(0), rec_result(NULL), shared_result(NULL)
   { unit->with_element= this; }
 
   bool check_dependencies_in_spec();
@@ -206,6 +215,8 @@ class With_element : public Sql_alloc
 
   void inc_references() { references++; }
 
+  uint get_references() { return references; }
+
   bool rename_columns_of_derived_unit(THD *thd, st_select_lex_unit *unit);
 
   bool prepare_unreferenced(THD *thd);
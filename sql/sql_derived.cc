@@ -1064,6 +1064,116 @@ bool TABLE_LIST::fill_recursive(THD *thd)
 }
 
 
+/**
+  @brief
+    Check whether this reference to a CTE may share its materialization
+
+  @details
+    The rows of a non-recursive CTE referenced several times are the same
+    for all references unless the optimizer has changed the specification
+    used for a reference: by pushing conditions into it or by choosing
+    a splitting plan for it (the latter makes the unit uncacheable).
+    Any reference with an unchanged specification can be filled with
+    the rows materialized for another such reference.
+
+  @retval
+    true   if the rows of this reference may be shared
+    false  otherwise
+*/
+
+bool TABLE_LIST::can_share_materialization()
+{
+  st_select_lex_unit *unit= get_unit();
+  if (!with || with->is_recursive || with->get_references() < 2 ||
+      unit->uncacheable || is_nonrecursive_derived_with_rec_ref())
+    return false;
+  for (st_select_lex *sl= unit->first_select(); sl; sl= sl->next_select())
+  {
+    if (sl->cond_pushed_into_where || sl->cond_pushed_into_having)
+      return false;
+  }
+  return true;
+}
+
+
+/**
+  @brief
+    Fill the table of this CTE reference with the shared rows
+
+  @param thd  The thread handle
+
+  @details
+    The method is called for a reference for which
+    can_share_materialization() returns true after the rows of the CTE
+    have been saved by save_for_sharing() for another reference.
+    The rows are copied into the table of this reference instead of
+    executing its specification.
+
+  @retval
+    false   on success
+    true    on failure
+*/
+
+bool TABLE_LIST::fill_from_shared(THD *thd)
+{
+  TABLE *src= with->shared_result->table;
+  bool rc= src->insert_all_rows_into_tmp_table(thd, table,
+                                               &derived_result->tmp_table_param,
+                                               false);
+  src->file->ha_rnd_end();
+  return rc;
+}
+
+
+/**
+  @brief
+    Save the rows of this CTE reference to be used for its other references
+
+  @param thd  The thread handle
+
+  @details
+    The method is called after the table of the first reference to
+    a non-recursive CTE that can share its materialization has been filled.
+    The rows are copied into a table owned by the with element, as the
+    table of this reference can be scanned by the join when the other
+    references are filled.
+
+  @retval
+    false   on success
+    true    on failure
+*/
+
+bool TABLE_LIST::save_for_sharing(THD *thd)
+{
+  st_select_lex_unit *unit= get_unit();
+  select_unit *result;
+  bool rc;
+
+  if (!(result= new (thd->mem_root) select_unit(thd)))
+    return true;
+  /* Use the same record format as the table of the reference */
+  thd->create_tmp_table_for_derived= TRUE;
+  rc= result->create_result_table(thd, &unit->types, FALSE,
+                                  (unit->first_select()->options |
+                                   thd->variables.option_bits |
+                                   TMP_TABLE_ALL_COLUMNS),
+                                  &alias, FALSE, TRUE, FALSE, 0);
+  thd->create_tmp_table_for_derived= FALSE;
+  if (rc)
+    return true;
+  /* The table is freed together with the derived tables of the statement */
+  result->table->next= thd->derived_tables;
+  thd->derived_tables= result->table;
+
+  rc= table->insert_all_rows_into_tmp_table(thd, result->table,
+                                            &result->tmp_table_param, false);
+  table->file->ha_rnd_end();
+  if (!rc)
+    with->shared_result= result;
+  return rc;
+}
+
+
 /*
   Execute subquery of a materialized derived table/view and fill the result
   table.
@@ -1108,6 +1218,8 @@ bool mysql_derived_fill(THD *thd, LEX *lex, TABLE_LIST *derived)
   select_unit *derived_result= derived->derived_result;
   SELECT_LEX *save_current_select= lex->current_select;
   bool derived_recursive_is_filled= false;
+  bool share_rows= false;
+  bool filled_from_shared= false;
 
   if (unit->executed && !derived_is_recursive &&
       (unit->uncacheable & UNCACHEABLE_DEPENDENT))
@@ -1125,7 +1237,18 @@ bool mysql_derived_fill(THD *thd, LEX *lex, TABLE_LIST *derived)
     }   
   }
   
-  if (derived_is_recursive)
+  if (!derived_is_recursive && derived->can_share_materialization())
+  {
+    share_rows= true;
+    filled_from_shared= derived->with->shared_result != NULL;
+  }
+
+  if (filled_from_shared)
+  {
+    /* The rows have been materialized for another reference to the CTE */
+    res= derived->fill_from_shared(thd);
+  }
+  else if (derived_is_recursive)
   {
     if (derived->is_with_table_recursive_reference())
     {
@@ -1170,6 +1293,8 @@ bool mysql_derived_fill(THD *thd, LEX *lex, TABLE_LIST *derived)
   {
     if (derived_result->flush())
       res= TRUE;
+    else if (share_rows && !filled_from_shared)
+      res= derived->save_for_sharing(thd);
     unit->executed= TRUE;
 
     if (derived->field_translation)
@@ -1229,6 +1354,8 @@ bool mysql_derived_reinit(THD *thd, LEX *lex, TABLE_LIST *derived)
   derived->merged_for_insert= FALSE;
   unit->unclean();
   unit->types.empty();
+  if (derived->with)
+    derived->with->shared_result= NULL;
   /* for derived tables & PS (which can't be reset by Item_subselect) */
   unit->reinit_exec_mechanism();
   for (st_select_lex *sl= unit->first_select(); sl; sl= sl->next_select())
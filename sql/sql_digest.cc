@@ -164,6 +164,44 @@ void compute_digest_md5(const sql_digest_storage *digest_storage, unsigned char
                    digest_storage->m_byte_count);
 }
 
+static inline ulonglong rotl64(ulonglong x, uint bits)
+{
+  return (x << bits) | (x >> (64 - bits));
+}
+
+/*
+  MurmurHash3 style hash of the token array, 8 bytes per step.
+  Tokens can not be hashed as they are added by the lexer,
+  because reductions remove tokens from the end of the array.
+*/
+ulonglong compute_digest_hash(const sql_digest_storage *digest_storage)
+{
+  const ulonglong c1= 0x87c37b91114253d5ULL, c2= 0x4cf5ad432745937fULL;
+  uint byte_count= MY_MIN(digest_storage->m_byte_count,
+                          digest_storage->m_token_array_length);
+  const uchar *pos= digest_storage->m_token_array;
+  const uchar *end= pos + byte_count;
+  ulonglong hash= byte_count, k;
+
+  for (; pos + 8 <= end; pos+= 8)
+  {
+    k= uint8korr(pos) * c1;
+    hash^= rotl64(k, 31) * c2;
+    hash= rotl64(hash, 27) * 5 + 0x52dce729;
+  }
+  for (k= 0; pos < end; pos++)
+    k= (k << 8) | *pos;
+  k*= c1;
+  hash^= rotl64(k, 31) * c2;
+
+  hash^= hash >> 33;
+  hash*= 0xff51afd7ed558ccdULL;
+  hash^= hash >> 33;
+  hash*= 0xc4ceb9fe1a85ec53ULL;
+  hash^= hash >> 33;
+  return hash;
+}
+
 /*
   Iterate token array and updates digest_text.
 */
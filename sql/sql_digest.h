@@ -109,6 +109,15 @@ typedef struct sql_digest_storage sql_digest_storage;
 */
 void compute_digest_md5(const sql_digest_storage *digest_storage, unsigned char *md5);
 
+/**
+  Compute a 64 bit digest hash.
+  Much cheaper than @c compute_digest_md5(), used to look up digests
+  for every statement. The MD5 hash is only needed to print DIGEST.
+  @param digest_storage The digest
+  @return The computed digest hash
+*/
+ulonglong compute_digest_hash(const sql_digest_storage *digest_storage);
+
 /**
   Compute a digest text.
   A 'digest text' is a textual representation of a query,
@@ -1024,7 +1024,8 @@ class Diagnostics_area: public Sql_state_errno,
 
   bool skip_flush() const
   {
-    DBUG_ASSERT(m_status == DA_OK || m_status == DA_OK_BULK);
+    DBUG_ASSERT(m_status == DA_OK || m_status == DA_OK_BULK ||
+                m_status == DA_EOF);
     return m_skip_flush;
   }
 
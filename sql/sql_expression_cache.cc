@@ -17,14 +17,10 @@
 #include "sql_base.h"
 #include "sql_select.h"
 #include "sql_expression_cache.h"
+#include "key.h"
 
 /**
-  Minimum hit ration to proceed on disk if in memory table overflowed.
-  hit_rate = hit / (miss + hit);
-*/
-#define EXPCACHE_MIN_HIT_RATE_FOR_DISK_TABLE 0.7
-/**
-  Minimum hit ratio to keep in memory table (do not switch cache off)
+  Minimum hit ratio to keep the cache switched on
   hit_rate = hit / (miss + hit);
 */
 #define EXPCACHE_MIN_HIT_RATE_FOR_MEM_TABLE  0.2
@@ -33,6 +29,17 @@
   impact in the case when the cache is not applicable)
 */
 #define EXPCACHE_CHECK_HIT_RATIO_AFTER 200
+/**
+  Number of lookups the cache is paused for the first time its hit ratio
+  is too low. The pause is doubled every next time up to the maximum, so
+  the cache costs at most EXPCACHE_CHECK_HIT_RATIO_AFTER misses per pause
+  when it is not applicable, and is switched on again if the parameters
+  start repeating later.
+*/
+#define EXPCACHE_FIRST_PAUSE (EXPCACHE_CHECK_HIT_RATIO_AFTER * 10)
+#define EXPCACHE_MAX_PAUSE (EXPCACHE_FIRST_PAUSE * 1024)
+/** Initial number of the hash table buckets (must be a power of 2) */
+#define EXPCACHE_INITIAL_BUCKETS 64
 
 /*
   Expression cache is used only for caching subqueries now, so its statistic
@@ -40,13 +47,17 @@
 */
 ulong subquery_cache_miss, subquery_cache_hit;
 
-Expression_cache_tmptable::Expression_cache_tmptable(THD *thd,
-                                                     List<Item> &dependants,
-                                                     Item *value)
+Expression_cache_hash::Expression_cache_hash(THD *thd,
+                                             List<Item> &dependants,
+                                             Item *value)
   :cache_table(NULL), table_thd(thd), tracker(NULL), items(dependants), val(value),
-   hit(0), miss(0), inited (0)
+   buckets(NULL), bucket_mask(0), entry_count(0), lru_first(NULL),
+   lru_last(NULL), entry_size(0), used_memory(0), max_memory(0),
+   last_hash(0), hit(0), miss(0), trial_hit(0), trial_miss(0),
+   pause_left(0), pause_length(EXPCACHE_FIRST_PAUSE), key_ready(FALSE),
+   inited (0)
 {
-  DBUG_ENTER("Expression_cache_tmptable::Expression_cache_tmptable");
+  DBUG_ENTER("Expression_cache_hash::Expression_cache_hash");
   DBUG_VOID_RETURN;
 };
 
@@ -55,10 +66,9 @@ Expression_cache_tmptable::Expression_cache_tmptable(THD *thd,
   Disable cache
 */
 
-void Expression_cache_tmptable::disable_cache()
+void Expression_cache_hash::disable_cache()
 {
-  if (cache_table->file->inited)
-    cache_table->file->ha_index_end();
+  free_entries();
   free_tmp_table(table_thd, cache_table);
   cache_table= NULL;
   update_tracker();
@@ -67,6 +77,121 @@ void Expression_cache_tmptable::disable_cache()
 }
 
 
+/**
+  Pause the cache because of its low hit ratio
+
+  @details
+  The entries are kept, so the cache starts with them when it is switched
+  on again after the pause.
+*/
+
+void Expression_cache_hash::pause_cache()
+{
+  DBUG_PRINT("info", ("pausing the cache for %lu lookups", pause_length));
+  pause_left= pause_length;
+  if (pause_length < EXPCACHE_MAX_PAUSE)
+    pause_length*= 2;
+  key_ready= FALSE;
+  update_tracker();
+}
+
+
+/**
+  Free all entries and the buckets of the hash table
+*/
+
+void Expression_cache_hash::free_entries()
+{
+  Entry *entry, *next;
+  for (entry= lru_first; entry; entry= next)
+  {
+    next= entry->lru_next;
+    my_free(entry);
+  }
+  my_free(buckets);
+  buckets= NULL;
+  lru_first= lru_last= NULL;
+  entry_count= 0;
+  used_memory= 0;
+}
+
+
+void Expression_cache_hash::lru_push_front(Entry *entry)
+{
+  entry->lru_prev= NULL;
+  entry->lru_next= lru_first;
+  if (lru_first)
+    lru_first->lru_prev= entry;
+  else
+    lru_last= entry;
+  lru_first= entry;
+}
+
+
+void Expression_cache_hash::lru_unlink(Entry *entry)
+{
+  if (entry->lru_prev)
+    entry->lru_prev->lru_next= entry->lru_next;
+  else
+    lru_first= entry->lru_next;
+  if (entry->lru_next)
+    entry->lru_next->lru_prev= entry->lru_prev;
+  else
+    lru_last= entry->lru_prev;
+}
+
+
+/**
+  Remove an entry from the hash table and free it
+*/
+
+void Expression_cache_hash::remove_entry(Entry *entry)
+{
+  Entry **pos= buckets + (entry->hash & bucket_mask);
+  while (*pos != entry)
+    pos= &(*pos)->next_in_bucket;
+  *pos= entry->next_in_bucket;
+  lru_unlink(entry);
+  my_free(entry);
+  entry_count--;
+  used_memory-= entry_size;
+}
+
+
+/**
+  Double the number of the hash table buckets
+
+  @details
+  If the memory can not be allocated the hash table keeps working with
+  longer chains.
+*/
+
+void Expression_cache_hash::grow_buckets()
+{
+  ulong new_mask= bucket_mask * 2 + 1;
+  size_t old_size= (bucket_mask + 1) * sizeof(Entry*);
+  size_t new_size= (new_mask + 1) * sizeof(Entry*);
+  Entry **new_buckets;
+
+  /* leave room for at least one entry when all others are evicted */
+  if (new_size + entry_size > max_memory ||
+      !(new_buckets= (Entry**) my_malloc(new_size,
+                                         MYF(MY_THREAD_SPECIFIC |
+                                             MY_ZEROFILL))))
+    return;
+  for (Entry *entry= lru_first; entry; entry= entry->lru_next)
+  {
+    Entry **pos= new_buckets + (entry->hash & new_mask);
+    entry->next_in_bucket= *pos;
+    *pos= entry;
+  }
+  my_free(buckets);
+  buckets= new_buckets;
+  bucket_mask= new_mask;
+  used_memory+= new_size - old_size;
+}
+
+
 /**
   Field enumerator for TABLE::add_tmp_key
 
@@ -82,23 +207,24 @@ static uint field_enumerator(uchar *arg)
 
 
 /**
-  Initialize temporary table and auxiliary structures for the expression
+  Initialize the hash table and auxiliary structures for the expression
   cache
 
   @details
-  The function creates a temporary table for the expression cache, defines
-  the search index and initializes auxiliary search structures used to check
-  whether a given set of of values of the expression parameters is in some
-  cache entry.
+  The function creates a temporary table definition for the expression
+  cache, defines the search key and initializes auxiliary search structures
+  used to build the key for a given set of values of the expression
+  parameters. The temporary table itself is never created, the entries
+  are kept in a hash table in memory.
 */
 
-void Expression_cache_tmptable::init()
+void Expression_cache_hash::init()
 {
   List_iterator<Item> li(items);
   Item_iterator_list it(li);
   uint field_counter;
   LEX_CSTRING cache_table_name= { STRING_WITH_LEN("subquery-cache-table") };
-  DBUG_ENTER("Expression_cache_tmptable::init");
+  DBUG_ENTER("Expression_cache_hash::init");
   DBUG_ASSERT(!inited);
   inited= TRUE;
   cache_table= NULL;
@@ -132,12 +258,21 @@ void Expression_cache_tmptable::init()
     DBUG_VOID_RETURN;
   }
 
-  if (cache_table->s->db_type() != heap_hton)
+  /*
+    The values are kept in the entries as images of the record fields,
+    which can't be done for BLOBs
+  */
+  for (uint i= 0; i < cache_table->s->fields; i++)
   {
-    DBUG_PRINT("error", ("we need only heap table"));
-    goto error;
+    if (cache_table->field[i]->flags & BLOB_FLAG)
+    {
+      DBUG_PRINT("error", ("can't cache a BLOB"));
+      goto error;
+    }
   }
 
+  max_memory= (size_t) MY_MIN(table_thd->variables.tmp_memory_table_size,
+                              table_thd->variables.max_heap_table_size);
   field_counter= 1;
 
   if (cache_table->alloc_keys(1) ||
@@ -149,16 +284,23 @@ void Expression_cache_tmptable::init()
     DBUG_PRINT("error", ("creating index failed"));
     goto error;
   }
-  cache_table->s->keys= 1;
-  ref.null_rejecting= 1;
-  ref.disable_cache= FALSE;
-  ref.has_record= 0;
-  ref.use_count= 0;
 
+  /* the key, the NULL flag and the packed value of the result */
+  entry_size= sizeof(Entry) + ref.key_length + 1 +
+    cache_table->field[0]->max_packed_col_length(
+      cache_table->field[0]->pack_length());
+  bucket_mask= EXPCACHE_INITIAL_BUCKETS - 1;
+  used_memory= EXPCACHE_INITIAL_BUCKETS * sizeof(Entry*);
+  if (used_memory + entry_size > max_memory)
+  {
+    DBUG_PRINT("error", ("not enough memory for the cache"));
+    goto error;
+  }
 
-  if (open_tmp_table(cache_table))
+  if (!(buckets= (Entry**) my_malloc(used_memory,
+                                     MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL))))
   {
-    DBUG_PRINT("error", ("Opening (creating) temporary table failed"));
+    DBUG_PRINT("error", ("Allocating the hash table failed"));
     goto error;
   }
 
@@ -178,7 +320,7 @@ void Expression_cache_tmptable::init()
 }
 
 
-Expression_cache_tmptable::~Expression_cache_tmptable()
+Expression_cache_hash::~Expression_cache_hash()
 {
   /* Add accumulated statistics */
   statistic_add(subquery_cache_miss, miss, &LOCK_status);
@@ -209,37 +351,75 @@ Expression_cache_tmptable::~Expression_cache_tmptable()
   @retval Expression_cache::MISS - otherwise
 */
 
-Expression_cache::result Expression_cache_tmptable::check_value(Item **value)
+Expression_cache::result Expression_cache_hash::check_value(Item **value)
 {
-  int res;
-  DBUG_ENTER("Expression_cache_tmptable::check_value");
+  KEY *key_info;
+  Entry *entry;
+  DBUG_ENTER("Expression_cache_hash::check_value");
 
-  if (cache_table)
+  key_ready= FALSE;
+  if (!cache_table)
+    DBUG_RETURN(Expression_cache::MISS);
+
+  if (pause_left)
+  {
+    if (--pause_left)
+      DBUG_RETURN(Expression_cache::MISS);
+    DBUG_PRINT("info", ("the pause is over, switching the cache on"));
+    trial_hit= trial_miss= 0;
+  }
+
+  if (cp_buffer_from_ref(table_thd, cache_table, &ref))
   {
-    DBUG_PRINT("info", ("status: %u  has_record %u",
-                        (uint)cache_table->status, (uint)ref.has_record));
-    if ((res= join_read_key2(table_thd, NULL, cache_table, &ref)) == 1)
-      DBUG_RETURN(ERROR);
+    miss++;
+    DBUG_RETURN(Expression_cache::MISS);
+  }
 
-    if (res)
+  key_info= cache_table->key_info;
+  last_hash= key_hashnr(key_info, ref.key_parts, ref.key_buff);
+  for (entry= buckets[last_hash & bucket_mask];
+       entry;
+       entry= entry->next_in_bucket)
+  {
+    if (entry->hash == last_hash &&
+        !key_buf_cmp(key_info, ref.key_parts, entry->key(), ref.key_buff))
+      break;
+  }
+
+  if (!entry)
+  {
+    if (((++trial_miss) == EXPCACHE_CHECK_HIT_RATIO_AFTER) &&
+        ((double)trial_hit / ((double)trial_hit + trial_miss)) <
+        EXPCACHE_MIN_HIT_RATE_FOR_MEM_TABLE)
     {
-      if (((++miss) == EXPCACHE_CHECK_HIT_RATIO_AFTER) &&
-          ((double)hit / ((double)hit + miss)) <
-          EXPCACHE_MIN_HIT_RATE_FOR_MEM_TABLE)
-      {
-        DBUG_PRINT("info",
-                   ("Early check: hit rate is not so good to keep the cache"));
-        disable_cache();
-      }
-
-      DBUG_RETURN(MISS);
+      DBUG_PRINT("info",
+                 ("Early check: hit rate is not so good to keep the cache"));
+      pause_cache();
     }
+    else
+      key_ready= TRUE;
+    miss++;
+    DBUG_RETURN(Expression_cache::MISS);
+  }
 
-    hit++;
-    *value= cached_result;
-    DBUG_RETURN(Expression_cache::HIT);
+  if (entry != lru_first)
+  {
+    lru_unlink(entry);
+    lru_push_front(entry);
   }
-  DBUG_RETURN(Expression_cache::MISS);
+
+  Field *field= cache_table->field[0];
+  uchar *from= entry->key() + ref.key_length;
+  if (*from++)
+    field->set_null();
+  else
+    field->set_notnull();
+  field->unpack(field->ptr, from, (uchar*) entry + entry_size, 0);
+
+  hit++;
+  trial_hit++;
+  *value= cached_result;
+  DBUG_RETURN(Expression_cache::HIT);
 }
 
 
@@ -250,65 +430,63 @@ Expression_cache::result Expression_cache_tmptable::check_value(Item **value)
 
   @details
   The function evaluates 'value' and puts the result into the cache as the
-  result of the expression for the current set of parameters.
+  result of the expression for the set of parameters missed by the last
+  check_value() call. If the memory limit is reached the least recently
+  used entries are evicted, unless the hit ratio is too low to keep the
+  cache switched on.
 
   @retval FALSE OK
   @retval TRUE  Error
 */
 
-my_bool Expression_cache_tmptable::put_value(Item *value)
+my_bool Expression_cache_hash::put_value(Item *value)
 {
-  int error;
-  DBUG_ENTER("Expression_cache_tmptable::put_value");
+  Entry *entry, **bucket;
+  uchar *to;
+  DBUG_ENTER("Expression_cache_hash::put_value");
   DBUG_ASSERT(inited);
 
-  if (!cache_table)
+  if (!cache_table || !key_ready)
   {
-    DBUG_PRINT("info", ("No table so behave as we successfully put value"));
+    DBUG_PRINT("info", ("Cache is off so behave as we successfully put value"));
     DBUG_RETURN(FALSE);
   }
+  key_ready= FALSE;
 
   *(items.head_ref())= value;
   fill_record(table_thd, cache_table, cache_table->field, items, TRUE, TRUE);
   if (unlikely(table_thd->is_error()))
-    goto err;;
+    goto err;
 
-  if (unlikely((error=
-                cache_table->file->ha_write_tmp_row(cache_table->record[0]))))
+  while (used_memory + entry_size > max_memory)
   {
-    /* create_myisam_from_heap will generate error if needed */
-    if (cache_table->file->is_fatal_error(error, HA_CHECK_DUP))
-      goto err;
-    else
+    double hit_rate= ((double)trial_hit / ((double)trial_hit + trial_miss));
+    DBUG_ASSERT(trial_miss > 0 && lru_last);
+    if (hit_rate < EXPCACHE_MIN_HIT_RATE_FOR_MEM_TABLE)
     {
-      double hit_rate= ((double)hit / ((double)hit + miss));
-      DBUG_ASSERT(miss > 0);
-      if (hit_rate < EXPCACHE_MIN_HIT_RATE_FOR_MEM_TABLE)
-      {
-        DBUG_PRINT("info", ("hit rate is not so good to keep the cache"));
-        disable_cache();
-        DBUG_RETURN(FALSE);
-      }
-      else if (hit_rate < EXPCACHE_MIN_HIT_RATE_FOR_DISK_TABLE)
-      {
-        DBUG_PRINT("info", ("hit rate is not so good to go to disk"));
-        if (cache_table->file->ha_delete_all_rows() ||
-            cache_table->file->ha_write_tmp_row(cache_table->record[0]))
-          goto err;
-      }
-      else
-      {
-        if (create_internal_tmp_table_from_heap(table_thd, cache_table,
-                                                cache_table_param.start_recinfo,
-                                                &cache_table_param.recinfo,
-                                                error, 1, NULL))
-          goto err;
-      }
+      DBUG_PRINT("info", ("hit rate is not so good to keep the cache"));
+      pause_cache();
+      DBUG_RETURN(FALSE);
     }
+    remove_entry(lru_last);
   }
-  cache_table->status= 0; /* cache_table->record contains an existed record */
-  ref.has_record= TRUE; /* the same as above */
-  DBUG_PRINT("info", ("has_record: TRUE  status: 0"));
+
+  if (!(entry= (Entry*) my_malloc(entry_size, MYF(MY_THREAD_SPECIFIC))))
+    goto err;
+  entry->hash= last_hash;
+  memcpy(entry->key(), ref.key_buff, ref.key_length);
+  to= entry->key() + ref.key_length;
+  *to++= cache_table->field[0]->is_null();
+  cache_table->field[0]->pack(to, cache_table->field[0]->ptr);
+
+  bucket= buckets + (last_hash & bucket_mask);
+  entry->next_in_bucket= *bucket;
+  *bucket= entry;
+  lru_push_front(entry);
+  entry_count++;
+  used_memory+= entry_size;
+  if (entry_count > bucket_mask + 1)
+    grow_buckets();
 
   DBUG_RETURN(FALSE);
 
@@ -318,7 +496,7 @@ my_bool Expression_cache_tmptable::put_value(Item *value)
 }
 
 
-void Expression_cache_tmptable::print(String *str, enum_query_type query_type)
+void Expression_cache_hash::print(String *str, enum_query_type query_type)
 {
   List_iterator<Item> li(items);
   Item *item;
@@ -100,14 +100,23 @@ class Expression_cache_tracker :public Sql_alloc
 
 
 /**
-  Implementation of expression cache over a temporary table
+  Implementation of expression cache as an in-memory hash table
+
+  @details
+  A temporary table is created for the parameters and the result of the
+  expression only to get their fields and a key over the parameters; the
+  table itself is never instantiated. The values of the parameters are
+  copied into a key buffer that is looked up in a hash table, and the
+  least recently used entries are evicted when the memory limit of the
+  in-memory temporary tables is reached. If the hit ratio is too low the
+  cache is paused for a number of lookups and then tried again.
 */
 
-class Expression_cache_tmptable :public Expression_cache
+class Expression_cache_hash :public Expression_cache
 {
 public:
-  Expression_cache_tmptable(THD *thd, List<Item> &dependants, Item *value);
-  virtual ~Expression_cache_tmptable();
+  Expression_cache_hash(THD *thd, List<Item> &dependants, Item *value);
+  virtual ~Expression_cache_hash();
   virtual result check_value(Item **value);
   virtual my_bool put_value(Item *value);
 
@@ -124,7 +133,7 @@ class Expression_cache_tmptable :public Expression_cache
   {
     if (tracker)
     {
-      tracker->set(hit, miss, (inited ? (cache_table ?
+      tracker->set(hit, miss, (inited ? ((cache_table && !pause_left) ?
                                          Expression_cache_tracker::OK :
                                          Expression_cache_tracker::STOPPED) :
                                Expression_cache_tracker::UNINITED));
@@ -132,17 +141,33 @@ class Expression_cache_tmptable :public Expression_cache
   }
 
 private:
+  /* Header of a cache entry, the key and the result value follow it */
+  struct Entry
+  {
+    Entry *next_in_bucket;
+    /* Neighbours in the LRU list, prev is the more recently used one */
+    Entry *lru_prev, *lru_next;
+    ulong hash;
+    uchar *key() { return (uchar*) (this + 1); }
+  };
+
   void disable_cache();
+  void pause_cache();
+  void free_entries();
+  void remove_entry(Entry *entry);
+  void lru_push_front(Entry *entry);
+  void lru_unlink(Entry *entry);
+  void grow_buckets();
 
   /* tmp table parameters */
   TMP_TABLE_PARAM cache_table_param;
-  /* temporary table to store this cache */
+  /* temporary table providing the fields and the key of this cache */
   TABLE *cache_table;
   /* Thread handle for the temporary table */
   THD *table_thd;
   /* EXPALIN/ANALYZE statistics */
   Expression_cache_tracker *tracker;
-  /* TABLE_REF for index lookup */
+  /* TABLE_REF to build the lookup key */
   struct st_table_ref ref;
   /* Cached result */
   Item_field *cached_result;
@@ -150,8 +175,26 @@ class Expression_cache_tmptable :public Expression_cache
   List<Item> &items;
   /* Value Item example */
   Item *val;
+  /* Hash table of the entries, the number of buckets is a power of 2 */
+  Entry **buckets;
+  ulong bucket_mask;
+  ulong entry_count;
+  /* The most and the least recently used entries */
+  Entry *lru_first, *lru_last;
+  /* Size of an entry and the memory used by the entries and the buckets */
+  size_t entry_size, used_memory, max_memory;
+  /* Hash of the key of the last missed lookup, valid if key_ready is set */
+  ulong last_hash;
   /* hit/miss counters */
   ulong hit, miss;
+  /* hit/miss counters since the cache was switched on the last time */
+  ulong trial_hit, trial_miss;
+  /* Number of lookups left to skip while the cache is paused */
+  ulong pause_left;
+  /* Number of lookups to skip the next time the cache is paused */
+  ulong pause_length;
+  /* Set on if ref.key_buff contains the key of the last missed lookup */
+  bool key_ready;
   /* Set on if the object has been succesfully initialized with init() */
   bool inited;
 };
@@ -239,6 +239,7 @@ class Item_window_func;
 struct sql_digest_state;
 class With_clause;
 class my_var;
+class Cached_join_order;
 
 #define ALLOC_ROOT_SET 1024
 
@@ -1034,6 +1035,8 @@ class st_select_lex: public st_select_lex_node
   Item *prep_having;/* saved HAVING clause for prepared statement processing */
   Item *cond_pushed_into_where;  /* condition pushed into the select's WHERE  */
   Item *cond_pushed_into_having; /* condition pushed into the select's HAVING */
+  /* join order saved to be reused by the next executions of the statement */
+  Cached_join_order *cached_join_order;
   /* Saved values of the WHERE and HAVING clauses*/
   Item::cond_result cond_value, having_value;
   /*
@@ -8067,7 +8067,17 @@ void mysql_parse(THD *thd, char *rawbuf, uint length,
   {
     LEX *lex= thd->lex;
 
-    bool err= parse_sql(thd, parser_state, NULL, true);
+    bool err;
+
+    /* Repeated statements can be executed without parsing them */
+    if (thd->variables.auto_parameterize_cache_size &&
+        thd->get_command() == COM_QUERY && !is_com_multi &&
+        !thd->slave_thread && !(mqh_used && thd->user_connect) &&
+        !(thd->variables.sql_mode & MODE_ORACLE) &&
+        mysql_auto_param_execute(thd, parser_state))
+      goto end_statement;
+
+    err= parse_sql(thd, parser_state, NULL, true);
 
     if (likely(!err))
     {
@@ -8131,6 +8141,7 @@ void mysql_parse(THD *thd, char *rawbuf, uint length,
 
       query_cache_abort(thd, &thd->query_cache_tls);
     }
+end_statement:
     THD_STAGE_INFO(thd, stage_freeing_items);
     sp_cache_enforce_limit(thd->sp_proc_cache, stored_program_cache_size);
     sp_cache_enforce_limit(thd->sp_func_cache, stored_program_cache_size);
@@ -10140,12 +10151,14 @@ bool parse_sql(THD *thd, Parser_state *parser_state,
     parser_state->m_digest_psi= MYSQL_DIGEST_START(thd->m_statement_psi);
 
     if (parser_state->m_input.m_compute_digest ||
-       (parser_state->m_digest_psi != NULL))
+       (parser_state->m_digest_psi != NULL) ||
+       (digest_consumers && thd->m_digest != NULL))
     {
       /*
         If either:
         - the caller wants to compute a digest
         - the performance schema wants to compute a digest
+        - a plugin wants digests of client statements
         set the digest listener in the lexer.
       */
       parser_state->m_lip.m_digest= thd->m_digest;
@@ -82,8 +82,24 @@ When one supplies long data for a placeholder:
     server doesn't care; also, the server doesn't notify the client whether
     it got the data or not; if there is any error, then it will be returned
     at statement execute.
+
+When auto_parameterize_cache_size is not 0 and a client sends a text
+protocol SELECT, INSERT, REPLACE, UPDATE or DELETE (COM_QUERY):
+
+  - The query is only scanned by the lexer, see auto_param_scan().
+    Literals used as values (compared to an expression, in IN lists,
+    BETWEEN, LIMIT and in INSERT ... VALUES rows) are replaced by '?'.
+    Literals in select lists are kept, as they name the result columns.
+  - The resulting text is looked up in the auto-parameterization cache of
+    the connection. On a miss it is prepared like PREPARE does.
+  - The prepared statement is executed like EXECUTE ... USING does, with
+    the literals as parameters, but the original query text is used for
+    the logs and the query cache.
+  - Statements which can't be prepared, or raise a warning while being
+    prepared, are remembered and parsed as usual.
 */
 
+#define MYSQL_LEX 1
 #include "mariadb.h"                          /* NO_EMBEDDED_ACCESS_CHECKS */
 #include "sql_priv.h"
 #include "unireg.h"
@@ -112,6 +128,7 @@ When one supplies long data for a placeholder:
 #include "sp_cache.h"
 #include "sql_handler.h"  // mysql_ha_rm_tables
 #include "probes_mysql.h"
+#include "lex_token.h"                          // TOK_GENERIC_VALUE
 #ifdef EMBEDDED_LIBRARY
 /* include MYSQL_BIND headers */
 #include <mysql.h>
@@ -155,7 +172,8 @@ class Prepared_statement: public Statement
   enum flag_values
   {
     IS_IN_USE= 1,
-    IS_SQL_PREPARE= 2
+    IS_SQL_PREPARE= 2,
+    IS_AUTO_PARAM= 4
   };
 
   THD *thd;
@@ -194,6 +212,8 @@ class Prepared_statement: public Statement
   inline bool is_in_use() { return flags & (uint) IS_IN_USE; }
   inline bool is_sql_prepare() const { return flags & (uint) IS_SQL_PREPARE; }
   void set_sql_prepare() { flags|= (uint) IS_SQL_PREPARE; }
+  inline bool is_auto_param() const { return flags & (uint) IS_AUTO_PARAM; }
+  void set_auto_param() { flags|= (uint) IS_AUTO_PARAM; }
   bool prepare(const char *packet, uint packet_length);
   bool execute_loop(String *expanded_query,
                     bool open_cursor,
@@ -3512,6 +3532,522 @@ void mysql_sql_stmt_close(THD *thd)
 }
 
 
+/***************************************************************************
+ Auto-parameterized statements
+****************************************************************************/
+
+/** Maximal nesting of parentheses in an auto-parameterized statement. */
+static const uint AUTO_PARAM_MAX_DEPTH= 32;
+
+
+/**
+  A client statement in the auto-parameterization cache of a connection.
+*/
+
+struct Auto_param_entry
+{
+  /** Next entry in insertion order, for eviction. */
+  Auto_param_entry *next;
+  /** NULL if the statement is parsed as usual. */
+  Prepared_statement *stmt;
+  /** Text with parameter markers, database, sql_mode and character sets. */
+  char *key;
+  size_t key_length;
+};
+
+
+static uchar *get_auto_param_key(const uchar *record, size_t *key_length,
+                                 my_bool not_used __attribute__((unused)))
+{
+  const Auto_param_entry *entry= (const Auto_param_entry *) record;
+  *key_length= entry->key_length;
+  return (uchar *) entry->key;
+}
+
+
+static void free_auto_param_entry(void *record)
+{
+  Auto_param_entry *entry= (Auto_param_entry *) record;
+  delete entry->stmt;
+  my_free(entry);
+}
+
+
+/**
+  Auto-parameterized statements of a connection, evicted in FIFO order.
+*/
+
+class Auto_param_cache
+{
+  HASH m_hash;
+  Auto_param_entry *m_first;
+  Auto_param_entry *m_last;
+public:
+  Auto_param_cache()
+    :m_first(NULL), m_last(NULL)
+  {
+    my_hash_init(&m_hash, &my_charset_bin, 16, 0, 0, get_auto_param_key,
+                 free_auto_param_entry, HASH_THREAD_SPECIFIC);
+  }
+  ~Auto_param_cache() { my_hash_free(&m_hash); }
+
+  Auto_param_entry *find(const String *key)
+  {
+    return (Auto_param_entry *) my_hash_search(&m_hash,
+                                               (const uchar *) key->ptr(),
+                                               key->length());
+  }
+
+  /**
+    Add a statement, evicting the oldest ones if the cache is full.
+    The statement is owned by the cache, or deleted if it can't be added.
+  */
+  Auto_param_entry *insert(const String *key, Prepared_statement *stmt,
+                           ulong max_size)
+  {
+    Auto_param_entry *entry;
+    while (m_first && m_hash.records >= max_size)
+    {
+      entry= m_first;
+      if (!(m_first= entry->next))
+        m_last= NULL;
+      my_hash_delete(&m_hash, (uchar *) entry);
+    }
+    if (!(entry= (Auto_param_entry *) my_malloc(sizeof(*entry) +
+                                                key->length(),
+                                                MYF(MY_WME |
+                                                    MY_THREAD_SPECIFIC))))
+    {
+      delete stmt;
+      return NULL;
+    }
+    entry->next= NULL;
+    entry->stmt= stmt;
+    entry->key= (char *) (entry + 1);
+    entry->key_length= key->length();
+    memcpy(entry->key, key->ptr(), key->length());
+    if (my_hash_insert(&m_hash, (uchar *) entry))
+    {
+      free_auto_param_entry(entry);
+      return NULL;
+    }
+    if (m_last)
+      m_last->next= entry;
+    else
+      m_first= entry;
+    m_last= entry;
+    return entry;
+  }
+};
+
+
+void auto_param_cache_free(THD *thd)
+{
+  delete thd->auto_param_cache;
+  thd->auto_param_cache= NULL;
+}
+
+
+/**
+  Create the item for a literal, the same way as the parser does.
+*/
+
+static Item *make_auto_param_literal(THD *thd, int token, YYSTYPE *yylval)
+{
+  int error;
+  switch (token) {
+  case NUM:
+  case LONG_NUM:
+    return new (thd->mem_root)
+             Item_int(thd, yylval->lex_str.str,
+                      (longlong) my_strtoll10(yylval->lex_str.str, NULL,
+                                              &error),
+                      yylval->lex_str.length);
+  case ULONGLONG_NUM:
+    return new (thd->mem_root) Item_uint(thd, yylval->lex_str.str,
+                                         yylval->lex_str.length);
+  case DECIMAL_NUM:
+    return new (thd->mem_root) Item_decimal(thd, yylval->lex_str.str,
+                                            yylval->lex_str.length,
+                                            thd->charset());
+  case FLOAT_NUM:
+    return new (thd->mem_root) Item_float(thd, yylval->lex_str.str,
+                                          yylval->lex_str.length);
+  case TEXT_STRING:
+    return thd->make_string_literal(yylval->lex_string_with_metadata);
+  }
+  DBUG_ASSERT(0);
+  return NULL;
+}
+
+
+/**
+  Check if a token can follow a literal which is replaced by a parameter
+  marker, that is if the literal is a complete operand.
+*/
+
+static bool auto_param_ends_operand(int token)
+{
+  switch (token) {
+  case END_OF_INPUT:
+  case ')':
+  case ',':
+  case AND_SYM:
+  case AND_AND_SYM:
+  case OR_SYM:
+  case OR2_SYM:
+  case XOR:
+  case THEN_SYM:
+  case ELSE:
+  case END:
+  case ESCAPE_SYM:
+  case WHERE:
+  case GROUP_SYM:
+  case HAVING:
+  case ORDER_SYM:
+  case LIMIT:
+  case OFFSET_SYM:
+  case FOR_SYM:
+  case LOCK_SYM:
+  case UNION_SYM:
+  case INTERSECT_SYM:
+  case EXCEPT_SYM:
+  case RETURNING_SYM:
+    return true;
+  }
+  return false;
+}
+
+
+/**
+  Scan a client statement with the lexer only, and replace the literals
+  used as values by parameter markers.
+
+  Only literals in the following contexts are replaced, where a parameter
+  marker is accepted and the statement is parsed the same way with it:
+    - expr <comparison> literal, expr [NOT] LIKE literal
+    - expr BETWEEN literal AND literal
+    - expr IN (literal, ...)
+    - LIMIT literal [, literal], OFFSET literal, for integers
+    - INSERT ... VALUES (literal, ...), ...
+  The literal must be followed by a token ending an operand, and it must
+  not be in a select list, where it would change the name of a column.
+
+  As the whole statement is scanned, the statement digest is computed like
+  when the statement is parsed.
+
+  @param thd          Thread handle
+  @param lip          Lexer, at the start of the statement
+  @param[out] text    Statement text with parameter markers
+  @param[out] params  Items of the replaced literals, in order
+
+  @retval FALSE  success
+  @retval TRUE   the statement can't be auto-parameterized, or an error
+*/
+
+static bool auto_param_scan(THD *thd, Lex_input_stream *lip, String *text,
+                            List<Item> *params)
+{
+  YYSTYPE yylval, literal_yylval;
+  const char *copied= lip->get_buf();
+  const char *literal_start= NULL, *literal_end= NULL;
+  int literal_token= 0;
+  int token, prev= 0, prev2;
+  uint depth= 0;
+  /* If the parentheses at each depth are an IN list or a VALUES row */
+  bool value_list[AUTO_PARAM_MAX_DEPTH];
+  /* If each depth is in a select list */
+  bool select_list[AUTO_PARAM_MAX_DEPTH];
+  bool insert, in_values= false, in_limit= false;
+  bool between= false, between_and= false, after_between_and;
+
+  token= lip->lex_token(&yylval, thd);
+  switch (token) {
+  case SELECT_SYM:
+  case INSERT:
+  case REPLACE:
+  case UPDATE_SYM:
+  case DELETE_SYM:
+    break;
+  default:
+    return TRUE;
+  }
+  insert= token == INSERT || token == REPLACE;
+  value_list[0]= false;
+  select_list[0]= token == SELECT_SYM;
+
+  for (;;)
+  {
+    prev2= prev;
+    prev= token;
+    after_between_and= between_and;
+    between_and= false;
+    token= lip->lex_token(&yylval, thd);
+
+    if (literal_start)
+    {
+      /* The previous token is a literal which can be replaced */
+      if (auto_param_ends_operand(token))
+      {
+        Item *item= make_auto_param_literal(thd, literal_token,
+                                            &literal_yylval);
+        if (!item || params->push_back(item, thd->mem_root) ||
+            text->append(copied, literal_start - copied) ||
+            text->append('?'))
+          return TRUE;
+        copied= literal_end;
+      }
+      literal_start= NULL;
+    }
+
+    if (!depth && token != '(' && token != ',' &&
+        token != VALUES && token != VALUE_SYM)
+      in_values= false;
+
+    switch (token) {
+    case NUM:
+    case LONG_NUM:
+    case ULONGLONG_NUM:
+    case DECIMAL_NUM:
+    case FLOAT_NUM:
+    case TEXT_STRING:
+    {
+      bool integer= token == NUM || token == LONG_NUM ||
+                    token == ULONGLONG_NUM;
+      bool value;
+      switch (prev) {
+      case '=':
+      case '<':
+      case '>':
+      case LE:
+      case GE:
+      case NE:
+      case EQUAL_SYM:
+      case LIKE:
+      case BETWEEN_SYM:
+        value= true;
+        break;
+      case AND_SYM:
+        value= after_between_and;
+        break;
+      case LIMIT:
+      case OFFSET_SYM:
+        value= integer;
+        break;
+      case ',':
+        value= value_list[depth] || (integer && in_limit);
+        break;
+      case '(':
+        value= value_list[depth];
+        break;
+      default:
+        value= false;
+      }
+      if (value && !select_list[depth])
+      {
+        literal_token= token;
+        literal_yylval= yylval;
+        literal_start= lip->get_tok_start();
+        literal_end= lip->get_ptr();
+      }
+      continue;                                 // Keep in_limit
+    }
+    case '(':
+      if (++depth == AUTO_PARAM_MAX_DEPTH)
+        return TRUE;
+      value_list[depth]= prev == IN_SYM ||
+                         (in_values && depth == 1 &&
+                          (prev == VALUES || prev == VALUE_SYM ||
+                           prev == ','));
+      select_list[depth]= select_list[depth - 1];
+      break;
+    case ')':
+      if (!depth)
+        return TRUE;
+      depth--;
+      break;
+    case SELECT_SYM:
+      /* ORDER BY 1 of a subquery in an IN list is not a value */
+      value_list[depth]= false;
+      select_list[depth]= true;
+      break;
+    case FROM:
+      select_list[depth]= depth && select_list[depth - 1];
+      break;
+    case VALUES:
+    case VALUE_SYM:
+      in_values= insert && !depth;
+      break;
+    case BETWEEN_SYM:
+      between= true;
+      break;
+    case AND_SYM:
+      between_and= between;
+      between= false;
+      break;
+    case NULL_SYM:
+      /* NULL is a literal for the digest, except in IS [NOT] NULL */
+      if (prev != IS && !((prev == NOT_SYM || prev == NOT2_SYM) &&
+                          prev2 == IS))
+        lip->reduce_digest_token(TOK_GENERIC_VALUE, NULL_SYM);
+      break;
+    case END_OF_INPUT:
+      if (depth)
+        return TRUE;
+      return text->append(copied, lip->get_end_of_query() - copied);
+    case ABORT_SYM:
+    case PARAM_MARKER:
+    case ';':
+    case 0:
+      return TRUE;
+    }
+    in_limit= (token == LIMIT || token == OFFSET_SYM ||
+               (token == ',' && in_limit));
+  }
+}
+
+
+/**
+  Prepare a statement with parameter markers for the cache.
+
+  @return the statement, or NULL if it can't be prepared or raised
+          a warning
+*/
+
+static Prepared_statement *auto_param_prepare(THD *thd, const char *text,
+                                              uint text_length)
+{
+  Prepared_statement *stmt;
+
+  if (!(stmt= new Prepared_statement(thd)))
+    return NULL;
+  stmt->set_sql_prepare();
+  stmt->set_auto_param();
+
+  /* See comments on THD::change_list in mysql_sql_stmt_prepare() */
+  Item_change_list_savepoint change_list_savepoint(thd);
+  if (stmt->prepare(text, text_length) ||
+      thd->get_stmt_da()->current_statement_warn_count())
+  {
+    delete stmt;
+    stmt= NULL;
+  }
+  change_list_savepoint.rollback(thd);
+  return stmt;
+}
+
+
+/**
+  Execute a client statement as an auto-parameterized prepared statement
+  of the connection, preparing it if it's not cached yet.
+
+  Nothing is sent to the client if the statement is not executed: the
+  statement and its digest are then parsed as usual.
+
+  @param thd           Thread handle
+  @param parser_state  Parser state, initialized with the statement
+
+  @retval TRUE   the statement was executed
+  @retval FALSE  the statement must be parsed
+*/
+
+bool mysql_auto_param_execute(THD *thd, Parser_state *parser_state)
+{
+  Lex_input_stream *lip= &parser_state->m_lip;
+  char *query= (char *) lip->get_buf();
+  size_t query_length= lip->get_end_of_query() - query;
+  StringBuffer<1024> key(&my_charset_bin);
+  List<Item> params;
+  Auto_param_entry *entry= NULL;
+  Prepared_statement *stmt;
+  PSI_digest_locker *digest_psi;
+  Diagnostics_area new_stmt_da(thd->query_id, false, true);
+  Diagnostics_area *save_stmt_da= thd->get_stmt_da();
+  Item *free_list_backup;
+  bool error;
+  DBUG_ENTER("mysql_auto_param_execute");
+
+  if (!thd->auto_param_cache &&
+      !(thd->auto_param_cache= new Auto_param_cache()))
+    DBUG_RETURN(FALSE);
+
+  /* Errors and warnings mean that the statement is parsed as usual */
+  thd->set_stmt_da(&new_stmt_da);
+
+  thd->m_parser_state= parser_state;
+  digest_psi= MYSQL_DIGEST_START(thd->m_statement_psi);
+  if (thd->m_digest && (digest_psi || digest_consumers))
+  {
+    lip->m_digest= thd->m_digest;
+    lip->m_digest->m_digest_storage.m_charset_number= thd->charset()->number;
+  }
+  lip->stmt_prepare_mode= TRUE;                 // Return '?' as PARAM_MARKER
+  error= auto_param_scan(thd, lip, &key, &params);
+  lip->m_digest= NULL;
+  thd->m_parser_state= NULL;
+
+  /* Hide the literals, see comments on thd->free_list in mysql_sql_stmt_execute() */
+  free_list_backup= thd->free_list;
+  thd->free_list= NULL;
+
+  if (likely(!error))
+  {
+    uint text_length= key.length();
+    uint charsets[2]= { thd->variables.character_set_client->number,
+                        thd->variables.collation_connection->number };
+    error= (key.append('\0') ||
+            key.append(thd->db.str, thd->db.length) ||
+            key.append('\0') ||
+            key.append((const char *) &thd->variables.sql_mode,
+                       sizeof(thd->variables.sql_mode)) ||
+            key.append((const char *) charsets, sizeof(charsets)));
+    if (likely(!error) && !(entry= thd->auto_param_cache->find(&key)))
+      entry= thd->auto_param_cache->insert(&key,
+                                           auto_param_prepare(thd, key.ptr(),
+                                                              text_length),
+                                           thd->variables.
+                                             auto_parameterize_cache_size);
+    error= (error || !entry || !entry->stmt || entry->stmt->is_in_use() ||
+            entry->stmt->param_count != params.elements ||
+            new_stmt_da.is_error() ||
+            new_stmt_da.current_statement_warn_count());
+  }
+  thd->set_stmt_da(save_stmt_da);
+
+  if (error)
+  {
+    thd->free_items();
+    thd->free_list= free_list_backup;
+    if (thd->m_digest)
+      thd->m_digest->reset(thd->m_token_array, max_digest_length);
+    parser_state->reset(query, query_length);
+    DBUG_RETURN(FALSE);
+  }
+
+  stmt= entry->stmt;
+  if (digest_psi)
+    MYSQL_DIGEST_END(digest_psi, &thd->m_digest->m_digest_storage);
+  thd->m_statement_psi=
+    MYSQL_REFINE_STATEMENT(thd->m_statement_psi,
+                           sql_statement_info[stmt->lex->sql_command].m_key);
+
+  /* Log, binlog and cache the statement as it was sent */
+  String expanded_query(query, query_length, thd->charset());
+  thd->lex->prepared_stmt_params= params;
+  if (likely(!thd->lex->prepared_stmt_params_fix_fields(thd)))
+  {
+    Item_change_list_savepoint change_list_savepoint(thd);
+    (void) stmt->execute_loop(&expanded_query, FALSE, NULL, NULL);
+    change_list_savepoint.rollback(thd);
+  }
+  thd->free_items();
+  thd->free_list= free_list_backup;
+  stmt->lex->restore_set_statement_var();
+  thd->lex->sql_command= stmt->lex->sql_command;
+  DBUG_RETURN(TRUE);
+}
+
+
 /**
   Handle long data in pieces from client.
 
@@ -3784,6 +4320,8 @@ void Prepared_statement::setup_set_params()
   replace_params_with_values|= query_cache_is_cacheable_query(lex);
   // but never for compound statements
   replace_params_with_values&= lex->sql_command != SQLCOM_COMPOUND;
+  // nor for auto-parameterized statements, their original text is logged
+  replace_params_with_values&= !is_auto_param();
 
   if (replace_params_with_values)
   {
@@ -4070,8 +4608,9 @@ bool Prepared_statement::prepare(const char *packet, uint packet_len)
       we're inside a stored procedure (also called Dynamic SQL) --
       sub-statements inside stored procedures are not logged into
       the general log.
+      Auto-parameterized statements are logged as the client sent them.
     */
-    if (thd->spcont == NULL)
+    if (thd->spcont == NULL && !is_auto_param())
       general_log_write(thd, COM_STMT_PREPARE, query(), query_length());
   }
   DBUG_RETURN(error);
@@ -4474,6 +5013,8 @@ Prepared_statement::reprepare()
   copy.m_sql_mode= m_sql_mode;
 
   copy.set_sql_prepare(); /* To suppress sending metadata to the client. */
+  if (is_auto_param())
+    copy.set_auto_param(); /* To suppress logging the statement. */
 
   status_var_increment(thd->status_var.com_stmt_reprepare);
 
@@ -4825,7 +5366,7 @@ bool Prepared_statement::execute(String *expanded_query, bool open_cursor)
     sub-statements inside stored procedures are not logged into
     the general log.
   */
-  if (likely(error == 0 && thd->spcont == NULL))
+  if (likely(error == 0 && thd->spcont == NULL && !is_auto_param()))
     general_log_write(thd, COM_STMT_EXECUTE, thd->query(), thd->query_length());
 
 error:
@@ -24,6 +24,7 @@
 
 class THD;
 struct LEX;
+class Parser_state;
 
 /**
   An interface that is used to take an action when
@@ -83,6 +84,8 @@ void mysqld_stmt_fetch(THD *thd, char *packet, uint packet_length);
 void mysqld_stmt_reset(THD *thd, char *packet);
 void mysql_stmt_get_longdata(THD *thd, char *pos, ulong packet_length);
 void reinit_stmt_before_use(THD *thd, LEX *lex);
+bool mysql_auto_param_execute(THD *thd, Parser_state *parser_state);
+void auto_param_cache_free(THD *thd);
 
 my_bool bulk_parameters_iterations(THD *thd);
 my_bool bulk_parameters_set(THD *thd);
@@ -105,6 +105,8 @@ void best_access_path(JOIN *join, JOIN_TAB *s,
                              bool disable_jbuf, double record_count,
                              POSITION *pos, POSITION *loose_scan_pos);
 static void optimize_straight_join(JOIN *join, table_map join_tables);
+static bool reuse_cached_join_order(JOIN *join, table_map join_tables);
+static void cache_join_order(JOIN *join);
 static bool greedy_search(JOIN *join, table_map remaining_tables,
                           uint depth, uint prune_level,
                           uint use_cond_selectivity);
@@ -2780,6 +2782,34 @@ bool JOIN::add_fields_for_current_rowid(JOIN_TAB *cur, List<Item> *table_fields)
 }
 
 
+/**
+  Check whether the ORDER BY sort is done over a temporary table that
+  already holds the final, fully aggregated groups.
+
+  @param sort_tab  JOIN_TAB the ORDER BY filesort is attached to
+
+  @details
+    When this is the case every row read by filesort is a result row, so
+    the sort can keep only the top LIMIT groups in a Bounded_queue instead
+    of sorting all of them. This is not possible if some rows may still be
+    removed after the sort: by a HAVING that could not be pushed down to
+    the sorted table, by duplicate removal, by window functions or by a
+    PROCEDURE clause.
+
+  @retval true   The sort can be limited to unit->select_limit_cnt rows
+  @retval false  All groups must be sorted
+*/
+
+bool JOIN::sort_over_final_groups(JOIN_TAB *sort_tab) const
+{
+  return (sort_tab >= join_tab + top_join_tab_count &&
+          !group && !group_list &&
+          !having && !sort_tab->distinct && !procedure &&
+          rollup.state == ROLLUP::STATE_NONE &&
+          !select_lex->have_window_funcs());
+}
+
+
 /**
   Set info for aggregation tables
 
@@ -3311,9 +3341,15 @@ bool JOIN::make_aggr_tables_info()
           "select SQL_CALC_FOUND_ROWS * from t1 order by b desc limit 1;"
         m_select_limit == HA_POS_ERROR (we need a full table scan)
         unit->select_limit_cnt == 1 (we only need one row in the result set)
+
+        If grouping has already been completed into a temporary table, the
+        rows of that table are final groups and we can keep only the top N
+        of them, provided nothing filters or collapses rows after the sort:
+          "select a, sum(b) from t1 group by a order by 2 desc limit 10;"
       */
       sort_tab->filesort->limit=
-        (has_group_by || (join_tab + table_count > curr_tab + 1)) ?
+        ((has_group_by && !sort_over_final_groups(sort_tab)) ||
+         (join_tab + table_count > curr_tab + 1)) ?
          select_limit : unit->select_limit_cnt;
     }
     if (!only_const_tables() &&
@@ -5136,8 +5172,13 @@ make_join_statistics(JOIN *join, List<TABLE_LIST> &tables_list,
     /* Find an optimal join order of the non-constant tables. */
     if (join->const_tables != join->table_count)
     {
-      if (choose_plan(join, all_table_map & ~join->const_table_map))
-        goto error;
+      if (!reuse_cached_join_order(join,
+                                   all_table_map & ~join->const_table_map))
+      {
+        if (choose_plan(join, all_table_map & ~join->const_table_map))
+          goto error;
+        cache_join_order(join);
+      }
     }
     else
     {
@@ -7563,6 +7604,172 @@ static void choose_initial_table_order(JOIN *join)
 }
 
 
+/*
+  Max ratio between the estimates of rows of a table for the current
+  execution and for the execution a cached join order was chosen for
+  that still allows to reuse the order
+*/
+#define JOIN_ORDER_CACHE_ROWS_RATIO 2
+
+/**
+  Check whether the join order of a join can be saved to be reused
+
+  @details
+    The order is saved only for selects of prepared statements and of
+    stored routines, as the select is destroyed after the execution of
+    a conventional statement. Joins with semi-join nests are not supported
+    as their plans include the semi-join strategies chosen together with
+    the join order.
+*/
+
+static bool join_order_can_be_cached(JOIN *join)
+{
+  THD *thd= join->thd;
+  return (thd->variables.optimizer_reuse_join_order &&
+          !thd->stmt_arena->is_conventional() &&
+          !join->emb_sjm_nest &&
+          !join->select_lex->sj_nests.elements &&
+          !(join->select_options & SELECT_STRAIGHT_JOIN) &&
+          join->table_count - join->const_tables > 1);
+}
+
+
+static inline bool rows_in_cached_band(ha_rows rows, ha_rows cached_rows)
+{
+  double ratio= ((double) MY_MAX(rows, 1)) / MY_MAX(cached_rows, 1);
+  return ratio <= JOIN_ORDER_CACHE_ROWS_RATIO &&
+         ratio * JOIN_ORDER_CACHE_ROWS_RATIO >= 1.0;
+}
+
+
+/**
+  Build the query plan using the join order saved for the select
+
+  @param join         pointer to the structure providing all context info for
+                      the query
+  @param join_tables  set of the tables in the query
+
+  @details
+    The join order chosen by choose_plan() for a select of a prepared
+    statement or a stored routine is saved by cache_join_order(). If the
+    order is still valid for the current execution it is used to build
+    the plan with optimize_straight_join() instead of searching for the
+    best order again. Only the access methods for the tables are chosen,
+    so the cost of the optimization grows linearly with the number of
+    tables.
+
+    The order is considered valid if the same tables are constant and the
+    estimated numbers of rows of each table, that depend on the values of
+    the parameters through range analysis, are within the ratio of
+    JOIN_ORDER_CACHE_ROWS_RATIO of the estimates the order was chosen for.
+    The order must also still satisfy the dependencies of the tables and
+    the nesting of outer joins.
+
+    The saved order is lost when the statement is re-prepared, e.g.
+    after a change of the metadata of the used tables.
+
+  @retval
+    TRUE        the plan has been built using the saved order
+  @retval
+    FALSE       the order has to be chosen by choose_plan()
+*/
+
+static bool reuse_cached_join_order(JOIN *join, table_map join_tables)
+{
+  Cached_join_order *cache= join->select_lex->cached_join_order;
+  JOIN_TAB *order[MAX_TABLES];
+  JOIN_TAB **first= join->best_ref + join->const_tables;
+  uint n= join->table_count - join->const_tables;
+  table_map prefix_tables= join->const_table_map;
+  bool valid= TRUE;
+  DBUG_ENTER("reuse_cached_join_order");
+
+  if (!cache || !join_order_can_be_cached(join) ||
+      cache->table_count != join->table_count ||
+      cache->const_table_map != join->const_table_map)
+    DBUG_RETURN(FALSE);
+
+  join->cur_embedding_map= 0;
+  reset_nj_counters(join, join->join_list);
+  for (uint i= 0; i < n && valid; i++)
+  {
+    JOIN_TAB *tab= NULL;
+    for (uint j= 0; j < n; j++)
+    {
+      if (first[j]->table->tablenr == cache->tablenr[i])
+      {
+        tab= first[j];
+        break;
+      }
+    }
+    valid= (tab &&
+            !(tab->dependent & ~prefix_tables) &&
+            rows_in_cached_band(tab->found_records, cache->found_records[i]) &&
+            !check_interleaving_with_nj(tab));
+    if (valid)
+    {
+      order[i]= tab;
+      prefix_tables|= tab->table->map;
+    }
+  }
+  join->cur_embedding_map= 0;
+  reset_nj_counters(join, join->join_list);
+  if (!valid)
+    DBUG_RETURN(FALSE);
+
+  memcpy(first, order, sizeof(JOIN_TAB*) * n);
+  join->cur_sj_inner_tables= 0;
+  optimize_straight_join(join, join_tables);
+  if (join->thd->lex->is_single_level_stmt())
+    join->thd->status_var.last_query_cost= join->best_read;
+  DBUG_RETURN(TRUE);
+}
+
+
+/**
+  Save the join order chosen by choose_plan() to be reused
+
+  @details
+    See reuse_cached_join_order(). The order is kept in the memory of the
+    statement. Memory for it is allocated once, as the number of tables
+    of the select does not change between executions.
+*/
+
+static void cache_join_order(JOIN *join)
+{
+  THD *thd= join->thd;
+  Cached_join_order *cache= join->select_lex->cached_join_order;
+  uint n= join->table_count - join->const_tables;
+  DBUG_ENTER("cache_join_order");
+
+  if (!join_order_can_be_cached(join))
+    DBUG_VOID_RETURN;
+
+  if (!cache || cache->table_count < join->table_count)
+  {
+    MEM_ROOT *mem_root= thd->stmt_arena->mem_root;
+    if (!(cache= new (mem_root) Cached_join_order) ||
+        !(cache->tablenr= (uint *) alloc_root(mem_root,
+                                              sizeof(uint) *
+                                              join->table_count)) ||
+        !(cache->found_records= (ha_rows *) alloc_root(mem_root,
+                                                       sizeof(ha_rows) *
+                                                       join->table_count)))
+      DBUG_VOID_RETURN;
+    join->select_lex->cached_join_order= cache;
+  }
+  cache->table_count= join->table_count;
+  cache->const_table_map= join->const_table_map;
+  for (uint i= 0; i < n; i++)
+  {
+    JOIN_TAB *tab= join->best_positions[join->const_tables + i].table;
+    cache->tablenr[i]= tab->table->tablenr;
+    cache->found_records[i]= tab->found_records;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
 /**
   Selects and invokes a search strategy for an optimal query plan.
 
@@ -17144,6 +17351,7 @@ create_tmp_table(THD *thd, TMP_TABLE_PARAM *param, List<Item> &fields,
   uint fieldnr= 0;
   ulong reclength, string_total_length;
   bool  using_unique_constraint= false;
+  bool  blobs_need_disk;
   bool  use_packed_rows= false;
   bool  not_all_columns= !(select_options & TMP_TABLE_ALL_COLUMNS);
   char  *tmpname,path[FN_REFLEN];
@@ -17529,9 +17737,22 @@ create_tmp_table(THD *thd, TMP_TABLE_PARAM *param, List<Item> &fields,
   share->fields= field_count;
   share->column_bitmap_size= bitmap_buffer_size(share->fields);
 
+  /*
+    HEAP keeps BLOB values off-row but can't index them, so a grouping or
+    distinct key that covers a BLOB requires the on-disk engine.
+    INFORMATION_SCHEMA tables with BLOBs keep using the on-disk engine as
+    before, as their engine is visible in SHOW CREATE TABLE.
+  */
+  blobs_need_disk= blob_count && (distinct || param->schema_table);
+  for (ORDER *tmp= group; tmp && blob_count && !blobs_need_disk; tmp= tmp->next)
+  {
+    if ((*tmp->item)->get_tmp_table_field()->flags & BLOB_FLAG)
+      blobs_need_disk= true;
+  }
+
   /* If result table is small; use a heap */
   /* future: storage engine selection can be made dynamic? */
-  if (blob_count || using_unique_constraint
+  if (blobs_need_disk || using_unique_constraint
       || (thd->variables.big_tables && !(select_options & SELECT_SMALL_RESULT))
       || (select_options & TMP_TABLE_FORCE_MYISAM)
       || thd->variables.tmp_memory_table_size == 0)
@@ -22688,8 +22909,8 @@ JOIN_TAB::remove_duplicates()
     thd->reset_killed();
 
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table, field_count, first_field,
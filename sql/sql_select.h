@@ -988,6 +988,25 @@ class JOIN_TAB_RANGE: public Sql_alloc
   JOIN_TAB *end;
 };
 
+/*
+  The join order chosen for a select of a prepared statement or of a stored
+  routine, saved to be reused by the next executions of the statement
+  (see optimizer_reuse_join_order)
+*/
+
+class Cached_join_order: public Sql_alloc
+{
+public:
+  /* Number of tables in the join the order was chosen for */
+  uint table_count;
+  /* Constant tables of that join */
+  table_map const_table_map;
+  /* TABLE::tablenr of the non-constant tables in the join order */
+  uint *tablenr;
+  /* JOIN_TAB::found_records of the same tables the order was chosen for */
+  ha_rows *found_records;
+};
+
 class Pushdown_query;
 
 /**
@@ -1790,6 +1809,7 @@ class JOIN :public Sql_alloc
 
   void cleanup_item_list(List<Item> &items) const;
   bool add_having_as_table_cond(JOIN_TAB *tab);
+  bool sort_over_final_groups(JOIN_TAB *sort_tab) const;
   bool make_aggr_tables_info();
   bool add_fields_for_current_rowid(JOIN_TAB *cur, List<Item> *fields);
 };
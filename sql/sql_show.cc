@@ -63,6 +63,7 @@
 #include "ha_partition.h"
 #endif
 #include "transaction.h"
+#include "threadpool.h"
 
 enum enum_i_s_events_fields
 {
@@ -8965,6 +8966,22 @@ int fill_key_cache_tables(THD *thd, TABLE_LIST *tables, COND *cond)
 }
 
 
+/*
+  Fill INFORMATION_SCHEMA.THREAD_POOL_GROUPS. The table is empty unless
+  thread_handling=pool-of-threads, and for users without PROCESS privilege.
+*/
+
+static int fill_thread_pool_groups(THD *thd, TABLE_LIST *tables, COND *cond)
+{
+  DBUG_ENTER("fill_thread_pool_groups");
+#ifdef HAVE_POOL_OF_THREADS
+  if (!check_global_access(thd, PROCESS_ACL, true))
+    DBUG_RETURN(tp_fill_groups_info(thd, tables->table));
+#endif
+  DBUG_RETURN(0);
+}
+
+
 ST_FIELD_INFO schema_fields_info[]=
 {
   {"CATALOG_NAME", FN_REFLEN, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE},
@@ -9764,6 +9781,25 @@ ST_FIELD_INFO check_constraints_fields_info[]=
    OPEN_FULL_TABLE},
   {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE}
 };
+ST_FIELD_INFO thread_pool_groups_fields_info[]=
+{
+  {"GROUP_ID", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, SKIP_OPEN_TABLE},
+  {"CONNECTIONS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, SKIP_OPEN_TABLE},
+  {"THREADS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, SKIP_OPEN_TABLE},
+  {"ACTIVE_THREADS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0,
+   SKIP_OPEN_TABLE},
+  {"STANDBY_THREADS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0,
+   SKIP_OPEN_TABLE},
+  {"QUEUE_LENGTH", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0,
+   SKIP_OPEN_TABLE},
+  {"HAS_LISTENER", 3, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"IS_STALLED", 3, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"STOLEN_EVENTS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, SKIP_OPEN_TABLE},
+  {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE}
+};
+
+
 /*
   Description of ST_FIELD_INFO in table.h
 
@@ -9858,6 +9894,8 @@ ST_SCHEMA_TABLE schema_tables[]=
    get_all_tables, make_table_names_old_format, 0, 1, 2, 1, OPTIMIZE_I_S_TABLE},
   {"TABLE_PRIVILEGES", table_privileges_fields_info, 0,
    fill_schema_table_privileges, 0, 0, -1, -1, 0, 0},
+  {"THREAD_POOL_GROUPS", thread_pool_groups_fields_info, 0,
+   fill_thread_pool_groups, 0, 0, -1, -1, 0, 0},
   {"TRIGGERS", triggers_fields_info, 0,
    get_all_tables, make_old_format, get_schema_triggers_record, 5, 6, 0,
    OPEN_TRIGGER_ONLY|OPTIMIZE_I_S_TABLE},
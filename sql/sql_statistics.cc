@@ -307,6 +307,8 @@ inline int open_single_stat_table(THD *thd, TABLE_LIST *table,
   for the number of nulls in the column and for the size of the column
   values. There is also a container for distinct column values used
   to calculate the average number of records per distinct column value. 
+  Only the values of the sampled rows are put into the container, see
+  collect_statistics_for_table.
 */ 
 
 class Column_statistics_collected :public Column_statistics
@@ -318,13 +320,14 @@ class Column_statistics_collected :public Column_statistics
   ulonglong column_total_length; /* To accumulate the size of column values */
   Count_distinct_field *count_distinct; /* The container for distinct 
                                            column values */
+  ha_rows sampled_values; /* The number of values put into count_distinct */
 
   bool is_single_pk_col; /* TRUE <-> the only column of the primary key */ 
 
 public:
 
   inline void init(THD *thd, Field * table_field);
-  inline bool add(ha_rows rowno);
+  inline bool add(ha_rows rowno, bool sampled);
   inline void finish(ha_rows rows); 
   inline void cleanup();
 };
@@ -1540,6 +1543,7 @@ class Histogram_builder
   uint curr_bucket;        /* number of the current bucket to be built     */
   ulonglong count;         /* number of values retrieved                   */
   ulonglong count_distinct;    /* number of distinct values retrieved      */
+  ulonglong count_single_occurence; /* number of values retrieved once     */
 
 public: 
   Histogram_builder(Field *col, uint col_len, ha_rows rows)
@@ -1554,13 +1558,18 @@ class Histogram_builder
     curr_bucket= 0;
     count= 0;
     count_distinct= 0;    
+    count_single_occurence= 0;
   }
 
   ulonglong get_count_distinct() { return count_distinct; }
 
+  ulonglong get_count_single_occurence() { return count_single_occurence; }
+
   int next(void *elem, element_count elem_cnt)
   {
     count_distinct++;
+    if (elem_cnt == 1)
+      count_single_occurence++;
     count+= elem_cnt;
     if (curr_bucket == hist_width)
       return 0;
@@ -1590,6 +1599,17 @@ int histogram_build_walk(void *elem, element_count elem_cnt, void *arg)
   return hist_builder->next(elem, elem_cnt);
 }
 
+static
+int count_distinct_single_occurence_walk(void *elem, element_count elem_cnt,
+                                         void *arg)
+{
+  ulonglong *counts= (ulonglong *) arg;
+  counts[0]++;
+  if (elem_cnt == 1)
+    counts[1]++;
+  return 0;
+}
+
 C_MODE_END
 
 
@@ -1677,14 +1697,30 @@ class Count_distinct_field: public Sql_alloc
     return count;
   }
 
+  /*
+    @brief
+    Calculate the number of elements accumulated in the container of 'tree'
+    and the number of them that were added only once
+  */
+  ulonglong get_value(ulonglong *single_occurences)
+  {
+    ulonglong counts[2]= {0, 0};
+    tree->walk(table_field->table, count_distinct_single_occurence_walk,
+               (void*) counts);
+    *single_occurences= counts[1];
+    return counts[0];
+  }
+
   /*
     @brief
     Build the histogram for the elements accumulated in the container of 'tree'
   */
-  ulonglong get_value_with_histogram(ha_rows rows)
+  ulonglong get_value_with_histogram(ha_rows rows,
+                                     ulonglong *single_occurences)
   {
     Histogram_builder hist_builder(table_field, tree_key_length, rows);
     tree->walk(table_field->table,  histogram_build_walk, (void *) &hist_builder);
+    *single_occurences= hist_builder.get_count_single_occurence();
     return hist_builder.get_count_distinct();
   }
 
@@ -2458,6 +2494,7 @@ void Column_statistics_collected::init(THD *thd, Field *table_field)
 
   nulls= 0;
   column_total_length= 0;
+  sampled_values= 0;
   if (is_single_pk_col)
     count_distinct= NULL;
   if (table_field->flags & BLOB_FLAG)
@@ -2480,10 +2517,12 @@ void Column_statistics_collected::init(THD *thd, Field *table_field)
 
   @param
   rowno     The order number of the row
+  @param
+  sampled   TRUE <-> the row is in the sample used to count distinct values
 */
 
 inline
-bool Column_statistics_collected::add(ha_rows rowno)
+bool Column_statistics_collected::add(ha_rows rowno, bool sampled)
 {
 
   bool err= 0;
@@ -2496,13 +2535,53 @@ bool Column_statistics_collected::add(ha_rows rowno)
       set_not_null(COLUMN_STAT_MIN_VALUE);
     if (max_value && column->update_max(max_value, rowno == nulls))
       set_not_null(COLUMN_STAT_MAX_VALUE);
-    if (count_distinct)
+    if (count_distinct && sampled)
+    {
+      sampled_values++;
       err= count_distinct->add();
+    }
   } 
   return err;
 }
 
 
+/**
+  @brief
+  Estimate the average number of rows per distinct value of a column
+
+  @param
+  values            The number of not null values in the column
+  @param
+  sampled_values    The number of values in the sample
+  @param
+  distincts         The number of distinct values in the sample
+  @param
+  single_occurences The number of values that occur once in the sample
+
+  @details
+  The number of distinct values in the column is estimated with the Duj1
+  estimator of Haas and Stokes:
+    D = d / (1 - (1 - q) * f1 / n)
+  where n values were sampled with the probability q, d of them are
+  distinct and f1 of them occur only once in the sample. Without sampling
+  D= d.
+*/
+
+static
+double estimate_avg_frequency(ha_rows values, ha_rows sampled_values,
+                              ulonglong distincts,
+                              ulonglong single_occurences)
+{
+  if (sampled_values == values)
+    return (double) values / distincts;
+  double fraction= (double) sampled_values / values;
+  double estimate= distincts /
+                   (1.0 - (1.0 - fraction) * single_occurences /
+                          sampled_values);
+  return MY_MAX((double) values / estimate, 1.0);
+}
+
+
 /**
   @brief
   Get the results of aggregation when collecting the statistics on a column
@@ -2530,15 +2609,19 @@ void Column_statistics_collected::finish(ha_rows rows)
   }
   if (count_distinct)
   {
-    ulonglong distincts;
+    ulonglong distincts, single_occurences= 0;
     uint hist_size= count_distinct->get_hist_size();
-    if (hist_size == 0)
+    if (hist_size != 0)
+      distincts= count_distinct->get_value_with_histogram(sampled_values,
+                                                          &single_occurences);
+    else if (sampled_values == rows - nulls)
       distincts= count_distinct->get_value();
     else
-      distincts= count_distinct->get_value_with_histogram(rows - nulls);
+      distincts= count_distinct->get_value(&single_occurences);
     if (distincts)
     {
-      val= (double) (rows - nulls) / distincts;
+      val= estimate_avg_frequency(rows - nulls, sampled_values, distincts,
+                                  single_occurences);
       set_avg_frequency(val); 
       set_not_null(COLUMN_STAT_AVG_FREQUENCY);
     }
@@ -2668,6 +2751,33 @@ int collect_statistics_for_index(THD *thd, TABLE *table, uint index)
 }
 
 
+/**
+  @brief
+  Get the fraction of rows used to count distinct values of columns
+
+  @details
+  The fraction is set by analyze_sample_percentage. If it is 0, all rows
+  of small tables are used, and for bigger tables the sample grows
+  logarithmically with the number of rows.
+*/
+
+static double get_sample_fraction(THD *thd, handler *file)
+{
+  const double min_rows_for_sampling= 50000;
+  double percentage= thd->variables.sample_percentage;
+
+  if (percentage != 0)
+    return percentage / 100;
+
+  file->info(HA_STATUS_VARIABLE | HA_STATUS_NO_LOCK);
+  double records= (double) file->stats.records;
+  if (records < min_rows_for_sampling)
+    return 1.0;
+  return MY_MIN((min_rows_for_sampling + 4096 * log(200 * records)) / records,
+                1.0);
+}
+
+
 /**
   @brief 
   Collect statistical data for a table
@@ -2700,7 +2810,10 @@ int collect_statistics_for_index(THD *thd, TABLE *table, uint index)
   statistics on each column of the table and count the total number of the
   scanned rows. To calculate the value of 'avg_frequency' for a column the
   function constructs an object of the helper class Count_distinct_field
-  (or its derivation). Currently this class cannot count the number of
+  (or its derivation). Only the values from a random sample of the rows,
+  as set by analyze_sample_percentage, are put into this object, and the
+  number of distinct values in the column is estimated from them, see
+  estimate_avg_frequency. Currently this class cannot count the number of
   distinct values for blob columns. So the value of 'avg_frequency' for
   blob columns is always null.
   After the full table scan the function calls collect_statistics_for_index
@@ -2727,9 +2840,12 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
   Field *table_field;
   ha_rows rows= 0;
   handler *file=table->file;
+  double sample_fraction;
 
   DBUG_ENTER("collect_statistics_for_table");
 
+  sample_fraction= get_sample_fraction(thd, file);
+
   table->collected_stats->cardinality_is_null= TRUE;
   table->collected_stats->cardinality= 0;
 
@@ -2743,7 +2859,10 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
 
   restore_record(table, s->default_values);
 
-  /* Perform a full table scan to collect statistics on 'table's columns */
+  /*
+    Perform a full table scan to collect statistics on 'table's columns.
+    Only the distinct values of the sampled rows are counted.
+  */
   if (!(rc= file->ha_rnd_init(TRUE)))
   {  
     DEBUG_SYNC(table->in_use, "statistics_collection_start");
@@ -2756,12 +2875,14 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
       if (rc)
         break;
 
+      bool sampled= sample_fraction >= 1.0 ||
+                    my_rnd(&thd->rand) < sample_fraction;
       for (field_ptr= table->field; *field_ptr; field_ptr++)
       {
         table_field= *field_ptr;
         if (!bitmap_is_set(table->read_set, table_field->field_index))
           continue;  
-        if ((rc= table_field->collected_stats->add(rows)))
+        if ((rc= table_field->collected_stats->add(rows, sampled)))
           break;
       }
       if (rc)
@@ -1121,7 +1121,8 @@ class Frame_cursor : public Sql_alloc
 };
 
 /*
-  A class that owns cursor objects associated with a specific window function.
+  A class that owns cursor objects associated with a specific window function,
+  or with several window functions that use the same window frame.
 */
 class Cursor_manager
 {
@@ -1131,6 +1132,63 @@ class Cursor_manager
     return cursors.push_back(cursor);
   }
 
+  bool add_window_func(Item_window_func *item)
+  {
+    return window_funcs.push_back(item);
+  }
+
+  /*
+    Check if the window function can be computed by the cursors of this
+    manager: it must be a regular aggregate over the same window frame as
+    the functions already registered.
+  */
+  bool can_share_frame(Item_window_func *item, bool need_scan)
+  {
+    Window_spec *spec= window_funcs.head()->window_spec;
+    Window_spec *item_spec= item->window_spec;
+    return shareable && need_scan == scan_required &&
+           spec->partition_list == item_spec->partition_list &&
+           spec->order_list == item_spec->order_list &&
+           spec->window_frame == item_spec->window_frame;
+  }
+
+  /* Compute the window function with the existing cursors. */
+  bool share_frame(Item_window_func *item)
+  {
+    List_iterator_fast<Frame_cursor> iter(cursors);
+    Frame_cursor *fc;
+    while ((fc= iter++))
+    {
+      if (fc->add_sum_func(item->window_func()))
+        return true;
+    }
+    return add_window_func(item);
+  }
+
+  void set_shareable(bool need_scan)
+  {
+    shareable= true;
+    scan_required= need_scan;
+  }
+
+  SQL_I_List<ORDER> *get_partition_list()
+  {
+    return window_funcs.head()->window_spec->partition_list;
+  }
+
+  /* Clear all window functions, the current row starts a new partition. */
+  void clear_window_funcs()
+  {
+    List_iterator_fast<Item_window_func> iter(window_funcs);
+    Item_window_func *item_win;
+    while ((item_win= iter++))
+    {
+      /* TODO(cvicentiu)
+         Clearing window functions should happen through cursors. */
+      item_win->window_func()->clear();
+    }
+  }
+
   void initialize_cursors(READ_RECORD *info)
   {
     List_iterator_fast<Frame_cursor> iter(cursors);
@@ -1163,11 +1221,18 @@ class Cursor_manager
       cursor->next_row();
   }
 
+  Cursor_manager() : shareable(false), scan_required(false) {}
   ~Cursor_manager() { cursors.delete_elements(); }
 
 private:
   /* List of the cursors that this manager owns. */
   List<Frame_cursor> cursors;
+  /* Window functions computed by the cursors. */
+  List<Item_window_func> window_funcs;
+  /* TRUE <=> the cursors are regular frame bounds, see can_share_frame(). */
+  bool shareable;
+  /* TRUE <=> the functions are computed by a Frame_scan_cursor. */
+  bool scan_required;
 };
 
 
@@ -2606,10 +2671,32 @@ void get_window_functions_required_cursors(
   List_iterator_fast<Item_window_func> it(window_functions);
   Item_window_func* item_win_func;
   Item_sum *sum_func;
+  Cursor_manager *prev_manager= NULL;
   while ((item_win_func= it++))
   {
-    Cursor_manager *cursor_manager = new Cursor_manager();
     sum_func = item_win_func->window_func();
+    bool need_scan= is_computed_with_remove(sum_func->sum_func()) &&
+                    !sum_func->supports_removal();
+    bool regular_frame= !item_win_func->requires_partition_size() &&
+                        !item_win_func->is_frame_prohibited() &&
+                        !item_win_func->requires_special_cursors();
+
+    /*
+      The functions come ordered by their window specifications, so the
+      functions over the same window frame are usually adjacent. Let them share
+      the frame cursors: every row of the frame is then read only once and
+      added to all of the functions.
+    */
+    if (regular_frame && prev_manager &&
+        prev_manager->can_share_frame(item_win_func, need_scan))
+    {
+      prev_manager->share_frame(item_win_func);
+      continue;
+    }
+
+    Cursor_manager *cursor_manager = new Cursor_manager();
+    cursor_manager->add_window_func(item_win_func);
+    prev_manager= NULL;
     Frame_cursor *fc;
     /*
       Some window functions require the partition size for computing values.
@@ -2670,8 +2757,7 @@ void get_window_functions_required_cursors(
     */
     cursor_manager->add_cursor(frame_bottom);
     cursor_manager->add_cursor(frame_top);
-    if (is_computed_with_remove(sum_func->sum_func()) &&
-        !sum_func->supports_removal())
+    if (need_scan)
     {
       frame_bottom->set_no_action();
       frame_top->set_no_action();
@@ -2681,20 +2767,22 @@ void get_window_functions_required_cursors(
       cursor_manager->add_cursor(scan_cursor);
 
     }
+    cursor_manager->set_shareable(need_scan);
     cursor_managers->push_back(cursor_manager);
+    prev_manager= cursor_manager;
   }
 }
 
 /**
   Helper function that takes a list of window functions and writes
-  their values in the current table record.
+  their values in the current table record. The table must be positioned
+  on the current row.
 */
 static
 bool save_window_function_values(List<Item_window_func>& window_functions,
-                                 TABLE *tbl, uchar *rowid_buf)
+                                 TABLE *tbl)
 {
   List_iterator_fast<Item_window_func> iter(window_functions);
-  tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
   store_record(tbl, record[1]);
   while (Item_window_func *item_win= iter++)
     item_win->save_in_field(item_win->result_field, true);
@@ -2749,7 +2837,6 @@ bool compute_window_func(THD *thd,
                          TABLE *tbl,
                          SORT_INFO *filesort_result)
 {
-  List_iterator_fast<Item_window_func> iter_win_funcs(window_functions);
   List_iterator_fast<Cursor_manager> iter_cursor_managers(cursor_managers);
   uint err;
 
@@ -2763,13 +2850,17 @@ bool compute_window_func(THD *thd,
   while ((cursor_manager= iter_cursor_managers++))
     cursor_manager->initialize_cursors(&info);
 
-  /* One partition tracker for each window function. */
+  /*
+    One partition tracker for each cursor manager. Window functions sharing
+    a frame share the cursor manager, so the partition is checked only once
+    for all of them.
+  */
   List<Group_bound_tracker> partition_trackers;
-  Item_window_func *win_func;
-  while ((win_func= iter_win_funcs++))
+  iter_cursor_managers.rewind();
+  while ((cursor_manager= iter_cursor_managers++))
   {
     Group_bound_tracker *tracker= new Group_bound_tracker(thd,
-                                        win_func->window_spec->partition_list);
+                                    cursor_manager->get_partition_list());
     // TODO(cvicentiu) This should be removed and placed in constructor.
     tracker->init();
     partition_trackers.push_back(tracker);
@@ -2789,20 +2880,16 @@ bool compute_window_func(THD *thd,
     tbl->file->position(tbl->record[0]);
     memcpy(rowid_buf, tbl->file->ref, tbl->file->ref_length);
 
-    iter_win_funcs.rewind();
     iter_part_trackers.rewind();
     iter_cursor_managers.rewind();
 
     Group_bound_tracker *tracker;
-    while ((win_func= iter_win_funcs++) &&
-           (tracker= iter_part_trackers++) &&
+    while ((tracker= iter_part_trackers++) &&
            (cursor_manager= iter_cursor_managers++))
     {
       if (tracker->check_if_next_group() || (rownum == 0))
       {
-        /* TODO(cvicentiu)
-           Clearing window functions should happen through cursors. */
-        win_func->window_func()->clear();
+        cursor_manager->clear_window_funcs();
         cursor_manager->notify_cursors_partition_changed(rownum);
       }
       else
@@ -2810,20 +2897,20 @@ bool compute_window_func(THD *thd,
         cursor_manager->notify_cursors_next_row();
       }
 
+      /* Return to current row after notifying cursors for each window
+         function. This is also the position save_window_function_values()
+         updates. */
+      tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
+
       /* Check if we found any error in the window function while adding values
          through cursors. */
       if (unlikely(thd->is_error() || thd->is_killed()))
         break;
-
-
-      /* Return to current row after notifying cursors for each window
-         function. */
-      tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
     }
 
     /* We now have computed values for each window function. They can now
        be saved in the current row. */
-    save_window_function_values(window_functions, tbl, rowid_buf);
+    save_window_function_values(window_functions, tbl);
 
     rownum++;
   }
@@ -366,6 +366,15 @@ static Sys_var_ulong Sys_auto_increment_offset(
        VALID_RANGE(1, 65535), DEFAULT(1), BLOCK_SIZE(1),
        NO_MUTEX_GUARD, IN_BINLOG);
 
+static Sys_var_ulong Sys_auto_parameterize_cache_size(
+       "auto_parameterize_cache_size",
+       "Maximum number of distinct SELECT, INSERT, REPLACE, UPDATE and DELETE "
+       "statements of one connection which are kept prepared, with their "
+       "literals replaced by parameters, so that repeating them with other "
+       "literals does not parse them again. 0 disables the cache",
+       SESSION_VAR(auto_parameterize_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64 * 1024), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_mybool Sys_automatic_sp_privileges(
        "automatic_sp_privileges",
        "Creating and dropping stored procedures alters ACLs",
@@ -2440,6 +2449,16 @@ static Sys_var_ulong Sys_open_files_limit(
        AUTO_SET READ_ONLY GLOBAL_VAR(open_files_limit), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, OS_FILE_LIMIT), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_optimizer_max_sel_arg_weight(
+       "optimizer_max_sel_arg_weight",
+       "The maximum number of ranges the range optimizer builds for an "
+       "index from conditions over several key parts. When the conditions "
+       "would produce more ranges, the conditions on the last key parts "
+       "are not used to build the ranges. If set to 0, there is no limit.",
+       SESSION_VAR(optimizer_max_sel_arg_weight), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(SEL_ARG::MAX_WEIGHT),
+       BLOCK_SIZE(1));
+
 /// @todo change to enum
 static Sys_var_ulong Sys_optimizer_prune_level(
        "optimizer_prune_level",
@@ -2450,6 +2469,16 @@ static Sys_var_ulong Sys_optimizer_prune_level(
        SESSION_VAR(optimizer_prune_level), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 1), DEFAULT(1), BLOCK_SIZE(1));
 
+static Sys_var_mybool Sys_optimizer_reuse_join_order(
+       "optimizer_reuse_join_order",
+       "Save the join order chosen for a select of a prepared statement or "
+       "a stored routine and reuse it in the following executions of the "
+       "statement instead of searching for the best join order again, as "
+       "long as the estimated numbers of rows of the tables differ at most "
+       "by the factor of 2 from the estimates the order was chosen for",
+       SESSION_VAR(optimizer_reuse_join_order), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
 static Sys_var_ulong Sys_optimizer_selectivity_sampling_limit(
        "optimizer_selectivity_sampling_limit",
        "Controls number of record samples to check condition selectivity",
@@ -5929,6 +5958,15 @@ static Sys_var_enum Sys_histogram_type(
        SESSION_VAR(histogram_type), CMD_LINE(REQUIRED_ARG),
        histogram_types, DEFAULT(0));
 
+static Sys_var_double Sys_analyze_sample_percentage(
+       "analyze_sample_percentage",
+       "Percentage of rows from the table ANALYZE TABLE will sample to "
+       "count the distinct values of columns for the statistics. "
+       "Set to 0 to let the server decide what percentage of rows to sample.",
+       SESSION_VAR(sample_percentage),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 100),
+       DEFAULT(100));
+
 static Sys_var_mybool Sys_no_thread_alarm(
        "debug_no_thread_alarm",
        "Disable system thread alarm calls. Disabling it may be useful "
@@ -2507,6 +2507,9 @@ struct TABLE_LIST
   void register_as_derived_with_rec_ref(With_element *rec_elem);
   bool is_nonrecursive_derived_with_rec_ref();
   bool fill_recursive(THD *thd);
+  bool can_share_materialization();
+  bool fill_from_shared(THD *thd);
+  bool save_for_sharing(THD *thd);
 
   inline void set_view()
   {
@@ -50,6 +50,9 @@
 #include "lf.h"
 #include "table.h"
 #include "sql_base.h"
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
 
 
 /** Configuration. */
@@ -215,6 +218,77 @@ struct Table_cache_instance
 static Table_cache_instance *tc;
 
 
+#ifdef HAVE_SCHED_GETCPU
+/**
+  Rank of each CPU for table cache instance selection.
+
+  CPUs of the same package (socket) get adjacent ranks, so that tc_instance()
+  maps them to the same or adjacent instances and table cache mutexes and
+  free lists are not shared between sockets.
+*/
+static uint *tc_cpu_rank;
+static uint tc_cpus;
+
+
+static void tc_init_cpu_rank()
+{
+  int ncpus= my_getncpus();
+  uint *package;
+
+  if (ncpus <= 1 ||
+      !(tc_cpu_rank= (uint*) my_malloc(2 * ncpus * sizeof(uint), MYF(0))))
+    return;
+  tc_cpus= (uint) ncpus;
+  package= tc_cpu_rank + tc_cpus;
+
+  for (uint cpu= 0; cpu < tc_cpus; cpu++)
+  {
+    char path[FN_REFLEN];
+    FILE *file;
+
+    package[cpu]= 0;
+    my_snprintf(path, sizeof(path),
+                "/sys/devices/system/cpu/cpu%u/topology/physical_package_id",
+                cpu);
+    if ((file= my_fopen(path, O_RDONLY, MYF(0))))
+    {
+      if (fscanf(file, "%u", &package[cpu]) != 1)
+        package[cpu]= 0;
+      my_fclose(file, MYF(0));
+    }
+  }
+
+  for (uint cpu= 0; cpu < tc_cpus; cpu++)
+  {
+    tc_cpu_rank[cpu]= 0;
+    for (uint other= 0; other < tc_cpus; other++)
+      if (package[other] < package[cpu] ||
+          (package[other] == package[cpu] && other < cpu))
+        tc_cpu_rank[cpu]++;
+  }
+}
+#endif
+
+
+/**
+  Select table cache instance for the current thread.
+
+  Threads running on the same socket share instances. If the CPU is not
+  known, instance is selected by thread id.
+*/
+
+static inline uint32 tc_instance(THD *thd, uint32 n_instances)
+{
+#ifdef HAVE_SCHED_GETCPU
+  int cpu;
+  if (tc_cpu_rank && (cpu= sched_getcpu()) >= 0)
+    return (uint32) ((ulonglong) tc_cpu_rank[(uint) cpu % tc_cpus] *
+                     n_instances / tc_cpus);
+#endif
+  return thd->thread_id % n_instances;
+}
+
+
 static void intern_close_table(TABLE *table)
 {
   delete table->triggers;
@@ -354,8 +428,9 @@ void tc_purge(bool mark_flushed)
 
 void tc_add_table(THD *thd, TABLE *table)
 {
-  uint32 i= thd->thread_id % my_atomic_load32_explicit((int32*) &tc_active_instances,
-                                                       MY_MEMORY_ORDER_RELAXED);
+  uint32 i= tc_instance(thd,
+                        my_atomic_load32_explicit((int32*) &tc_active_instances,
+                                                  MY_MEMORY_ORDER_RELAXED));
   TABLE *LRU_table= 0;
   TDC_element *element= table->s->tdc;
 
@@ -396,6 +471,29 @@ void tc_add_table(THD *thd, TABLE *table)
 }
 
 
+/**
+  Take unused TABLE object of a share from table cache instance.
+
+  @pre tc[i].LOCK_table_cache is locked.
+*/
+
+static TABLE *tc_pop_free_table(THD *thd, TDC_element *element, uint32 i)
+{
+  TABLE *table= element->free_tables[i].list.pop_front();
+  if (table)
+  {
+    DBUG_ASSERT(!table->in_use);
+    table->in_use= thd;
+    /* The ex-unused table must be fully functional. */
+    DBUG_ASSERT(table->db_stat && table->file);
+    /* The children must be detached from the table. */
+    DBUG_ASSERT(!table->file->extra(HA_EXTRA_IS_ATTACHED_CHILDREN));
+    tc[i].free_tables.remove(table);
+  }
+  return table;
+}
+
+
 /**
   Acquire TABLE object from table cache.
 
@@ -403,6 +501,14 @@ void tc_add_table(THD *thd, TABLE *table)
 
   Acquired object cannot be evicted or acquired again.
 
+  If instance of this thread has no unused objects of the share, other
+  active instances are tried: threads move between CPUs and instances get
+  activated, so unused objects may be left in other instances. Reusing
+  them is much cheaper than opening a new object, which also has to
+  reference the share under TDC_element::LOCK_table_share. Free lists of
+  other instances are peeked without lock, to avoid locking remote
+  instances that have nothing to offer.
+
   @return TABLE object, or NULL if no unused objects.
 */
 
@@ -411,22 +517,22 @@ TABLE *tc_acquire_table(THD *thd, TDC_element *element)
   uint32 n_instances=
     my_atomic_load32_explicit((int32*) &tc_active_instances,
                               MY_MEMORY_ORDER_RELAXED);
-  uint32 i= thd->thread_id % n_instances;
+  uint32 i= tc_instance(thd, n_instances);
   TABLE *table;
 
   tc[i].lock_and_check_contention(n_instances, i);
-  table= element->free_tables[i].list.pop_front();
-  if (table)
+  table= tc_pop_free_table(thd, element, i);
+  mysql_mutex_unlock(&tc[i].LOCK_table_cache);
+
+  for (uint32 j= (i + 1) % n_instances; !table && j != i;
+       j= (j + 1) % n_instances)
   {
-    DBUG_ASSERT(!table->in_use);
-    table->in_use= thd;
-    /* The ex-unused table must be fully functional. */
-    DBUG_ASSERT(table->db_stat && table->file);
-    /* The children must be detached from the table. */
-    DBUG_ASSERT(!table->file->extra(HA_EXTRA_IS_ATTACHED_CHILDREN));
-    tc[i].free_tables.remove(table);
+    if (element->free_tables[j].list.is_empty())
+      continue;
+    mysql_mutex_lock(&tc[j].LOCK_table_cache);
+    table= tc_pop_free_table(thd, element, j);
+    mysql_mutex_unlock(&tc[j].LOCK_table_cache);
   }
-  mysql_mutex_unlock(&tc[i].LOCK_table_cache);
   return table;
 }
 
@@ -621,6 +727,9 @@ bool tdc_init(void)
   /* Extra instance is allocated to avoid false sharing */
   if (!(tc= new Table_cache_instance[tc_instances + 1]))
     DBUG_RETURN(true);
+#ifdef HAVE_SCHED_GETCPU
+  tc_init_cpu_rank();
+#endif
   tdc_inited= true;
   mysql_mutex_init(key_LOCK_unused_shares, &LOCK_unused_shares,
                    MY_MUTEX_INIT_FAST);
@@ -676,6 +785,10 @@ void tdc_deinit(void)
     lf_hash_destroy(&tdc_hash);
     mysql_mutex_destroy(&LOCK_unused_shares);
     delete [] tc;
+#ifdef HAVE_SCHED_GETCPU
+    my_free(tc_cpu_rank);
+    tc_cpu_rank= 0;
+#endif
   }
   DBUG_VOID_RETURN;
 }
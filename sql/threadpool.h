@@ -56,6 +56,7 @@ extern void tp_set_threadpool_size(uint val);
 extern void tp_set_threadpool_stall_limit(uint val);
 extern int tp_get_idle_thread_count();
 extern int tp_get_thread_count();
+extern int tp_fill_groups_info(THD *thd, TABLE *table);
 
 /* Activate threadpool scheduler */
 extern void tp_scheduler(void);
@@ -128,6 +129,7 @@ struct TP_pool
   virtual int set_stall_limit(uint){ return 0; }
   virtual int get_thread_count() { return tp_stats.num_worker_threads; }
   virtual int get_idle_thread_count(){ return 0; }
+  virtual int fill_groups_info(THD *, TABLE *){ return 0; }
 };
 
 #ifdef _WIN32
@@ -153,4 +155,5 @@ struct TP_pool_generic :TP_pool
   virtual int set_pool_size(uint);
   virtual int set_stall_limit(uint);
   virtual int get_idle_thread_count();
+  virtual int fill_groups_info(THD *thd, TABLE *table);
 };
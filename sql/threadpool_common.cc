@@ -215,7 +215,7 @@ void tp_callback(TP_connection *c)
 
 static THD* threadpool_add_connection(CONNECT *connect, void *scheduler_data)
 {
-  THD *thd= NULL;
+  THD *thd= NULL, *cached_thd= NULL;
 
   /*
     Create a new connection context: mysys_thread_var and PSI thread
@@ -225,10 +225,18 @@ static THD* threadpool_add_connection(CONNECT *connect, void *scheduler_data)
   pthread_setspecific(THR_KEY_mysys, 0);
   my_thread_init();
   st_my_thread_var* mysys_var= (st_my_thread_var *)pthread_getspecific(THR_KEY_mysys);
-  if (!mysys_var ||!(thd= connect->create_thd(NULL)))
+  if (mysys_var && (cached_thd= get_cached_thd()))
+  {
+    /* Reused THD is reset in the context of the new connection */
+    cached_thd->set_mysys_var(mysys_var);
+    set_current_thd(cached_thd);
+  }
+  if (!mysys_var ||!(thd= connect->create_thd(cached_thd)))
   {
     /* Out of memory? */
     connect->close_and_delete();
+    if (cached_thd)
+      delete cached_thd;
     if (mysys_var)
     {
 #ifdef HAVE_PSI_INTERFACE
@@ -291,7 +299,10 @@ static void threadpool_remove_connection(THD *thd)
   end_connection(thd);
   close_connection(thd, 0);
   unlink_thd(thd);
-  delete thd;
+  /* mysys_var is freed below, a cached THD must not refer to it */
+  thd->reset_globals();
+  if (!cache_thd(thd))
+    delete thd;
 
   /*
     Free resources associated with this connection: 
@@ -437,6 +448,11 @@ int tp_get_thread_count()
   return pool ? pool->get_thread_count() : 0;
 }
 
+int tp_fill_groups_info(THD *thd, TABLE *table)
+{
+  return pool ? pool->fill_groups_info(thd, table) : 0;
+}
+
 void tp_set_min_threads(uint val)
 {
   if (pool)
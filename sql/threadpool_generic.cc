@@ -46,6 +46,7 @@ typedef int TP_file_handle;
 #include <debug_sync.h>
 #include <time.h>
 #include <sql_plist.h>
+#include <sql_show.h>
 #include <threadpool.h>
 #include <time.h>
 #ifdef __linux__
@@ -192,6 +193,8 @@ struct MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE) thread_group_t
   /* Stats for the deadlock detection timer routine.*/
   int io_event_count;
   int queue_event_count;
+  /* Number of events from the queue handled by workers of other groups */
+  ulonglong stolen_event_count;
   ulonglong last_thread_creation_time;
   int  shutdown_pipe[2];
   bool shutdown;
@@ -229,6 +232,8 @@ static int  wake_or_create_thread(thread_group_t *thread_group);
 static int  create_worker(thread_group_t *thread_group);
 static void *worker_main(void *param);
 static void check_stall(thread_group_t *thread_group);
+static TP_connection_generic *steal_event(thread_group_t *thread_group);
+static void wake_idle_group(thread_group_t *thread_group);
 static void set_next_timeout_check(ulonglong abstime);
 static void print_pool_blocked_message(bool);
 
@@ -572,6 +577,139 @@ static void queue_put(thread_group_t *thread_group, native_event *ev, int cnt)
   }
 }
 
+/**
+  Take an event of another group, for a worker that has nothing to do in
+  its own group.
+
+  Connections stay in their group, but the queued events of a busy group
+  would otherwise wait until its running queries finish, or until the
+  timer detects a stall. If the busy group has no listener, its pending
+  network events are polled too. While the worker handles the event, it
+  is counted as an active thread of the group of the connection, so that
+  wait_begin() and wait_end() keep the counters of that group right,
+  until return_stolen_event() moves it back.
+
+  The mutex of the current group is held, the mutex of the other group is
+  only tried, so that two groups stealing from each other cannot
+  deadlock.
+
+  @param thread_group - group of the current worker
+
+  @return connection with pending event, or NULL if there is none
+*/
+
+static TP_connection_generic *steal_event(thread_group_t *thread_group)
+{
+  uint count= group_count;
+  uint self= (uint) (thread_group - all_groups);
+
+  if (self >= count)
+    return NULL;
+
+  for (uint i= 1; i < count; i++)
+  {
+    thread_group_t *group= &all_groups[(self + i) % count];
+    TP_connection_generic *connection= NULL;
+
+    /* Dirty reads, to skip groups that obviously have no work for us */
+    if ((is_queue_empty(group) && group->listener) ||
+        !group->connection_count || mysql_mutex_trylock(&group->mutex))
+      continue;
+    if (!group->shutdown)
+    {
+      if (is_queue_empty(group) && !group->listener)
+      {
+        native_event ev[MAX_EVENTS];
+        int cnt= io_poll_wait(group->pollfd, ev, MAX_EVENTS, 0);
+        if (cnt > 0)
+        {
+          group->io_event_count+= cnt;
+          queue_put(group, ev, cnt);
+        }
+      }
+      /* Keeps the priority order of the queues */
+      connection= queue_get(group);
+      if (connection)
+      {
+        group->stolen_event_count++;
+        group->active_thread_count++;
+      }
+    }
+    mysql_mutex_unlock(&group->mutex);
+
+    if (connection)
+    {
+      thread_group->active_thread_count--;
+      return connection;
+    }
+  }
+  return NULL;
+}
+
+
+/**
+  Count the current worker again as an active thread of its own group
+  after it has handled an event taken by steal_event().
+
+  @param event_group - group of the connection of the event
+  @param thread_group - group of the current worker
+*/
+
+static void return_stolen_event(thread_group_t *event_group,
+                                thread_group_t *thread_group)
+{
+  mysql_mutex_lock(&event_group->mutex);
+  event_group->active_thread_count--;
+  DBUG_ASSERT(event_group->active_thread_count >= 0);
+  /* Like in wait_begin(), the group may stall without this thread. */
+  if (event_group->active_thread_count == 0 &&
+      !is_queue_empty(event_group))
+    wake_or_create_thread(event_group);
+  mysql_mutex_unlock(&event_group->mutex);
+
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->active_thread_count++;
+  mysql_mutex_unlock(&thread_group->mutex);
+}
+
+
+/**
+  Wake an idle worker of another group, so that it takes events from the
+  queue of a busy group with steal_event().
+
+  The mutex of the busy group is held, the mutexes of the other groups
+  are only tried.
+
+  @param thread_group - the busy group
+*/
+
+static void wake_idle_group(thread_group_t *thread_group)
+{
+  uint count= group_count;
+  uint self= (uint) (thread_group - all_groups);
+
+  if (self >= count)
+    return;
+
+  for (uint i= 1; i < count; i++)
+  {
+    thread_group_t *group= &all_groups[(self + i) % count];
+    bool woken= false;
+
+    if (group->waiting_threads.is_empty() ||
+        mysql_mutex_trylock(&group->mutex))
+      continue;
+    if (!group->shutdown && group->active_thread_count == 0 &&
+        is_queue_empty(group))
+      woken= !wake_thread(group);
+    mysql_mutex_unlock(&group->mutex);
+
+    if (woken)
+      return;
+  }
+}
+
+
 /* 
   Handle wait timeout : 
   Find connections that have been idle for too long and kill them.
@@ -886,6 +1024,15 @@ static TP_connection_generic * listener(worker_thread_t *current_thread,
         }
       }
     }
+    else
+    {
+      /*
+        All workers of the group are busy and the queue grows. Rather than
+        waiting for them, or for the timer to detect a stall, let an idle
+        worker of another group take some of the events, see steal_event().
+      */
+      wake_idle_group(thread_group);
+    }
     mysql_mutex_unlock(&thread_group->mutex);
   }
 
@@ -1224,7 +1371,12 @@ TP_connection_generic *get_event(worker_thread_t *current_thread,
     {
       connection = queue_get(thread_group);
       if(connection)
+      {
+        /* Let an idle group help with the rest of the queue. */
+        if (!is_queue_empty(thread_group))
+          wake_idle_group(thread_group);
         break;
+      }
     }
 
     /* If there is  currently no listener in the group, become one. */
@@ -1260,6 +1412,11 @@ TP_connection_generic *get_event(worker_thread_t *current_thread,
         connection= queue_get(thread_group);
         break;
       }
+
+      /* Help a group that has more work than it can handle. */
+      connection= steal_event(thread_group);
+      if (connection)
+        break;
     }
 
 
@@ -1589,7 +1746,10 @@ static void *worker_main(void *param)
     if (!connection)
       break;
     this_thread.event_count++;
+    thread_group_t *event_group= connection->thread_group;
     tp_callback(connection);
+    if (event_group != thread_group)
+      return_stolen_event(event_group, thread_group);
   }
 
   /* Thread shutdown: cleanup per-worker-thread structure. */
@@ -1722,6 +1882,49 @@ int TP_pool_generic::get_idle_thread_count()
 }
 
 
+/**
+  Fill INFORMATION_SCHEMA.THREAD_POOL_GROUPS, one row per thread group.
+*/
+
+int TP_pool_generic::fill_groups_info(THD *thd, TABLE *table)
+{
+  CHARSET_INFO *cs= system_charset_info;
+  for (uint i= 0; i < group_count; i++)
+  {
+    thread_group_t *group= &all_groups[i];
+    ulonglong queue_length= 0;
+    ulonglong standby_threads= 0;
+
+    mysql_mutex_lock(&group->mutex);
+    for (int j= 0; j < NQUEUES; j++)
+    {
+      connection_queue_t::Iterator it(group->queues[j]);
+      while (it++)
+        queue_length++;
+    }
+    worker_list_t::Iterator waiting(group->waiting_threads);
+    while (waiting++)
+      standby_threads++;
+    table->field[0]->store(i, true);
+    table->field[1]->store(group->connection_count, true);
+    table->field[2]->store(group->thread_count, true);
+    table->field[3]->store(group->active_thread_count, true);
+    table->field[4]->store(standby_threads, true);
+    table->field[5]->store(queue_length, true);
+    table->field[6]->store(group->listener ? "YES" : "NO",
+                           group->listener ? 3 : 2, cs);
+    table->field[7]->store(group->stalled ? "YES" : "NO",
+                           group->stalled ? 3 : 2, cs);
+    table->field[8]->store(group->stolen_event_count, true);
+    mysql_mutex_unlock(&group->mutex);
+
+    if (schema_table_store_record(thd, table))
+      return 1;
+  }
+  return 0;
+}
+
+
 /* Report threadpool problems */
 
 /** 
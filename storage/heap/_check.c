@@ -175,8 +175,7 @@ static int check_one_rb_key(HP_INFO *info, uint keynr, ulong records,
   uint key_length;
   uint not_used[2];
   
-  if ((key= tree_search_edge(&keydef->rb_tree, info->parents,
-			     &info->last_pos, offsetof(TREE_ELEMENT, left))))
+  if ((key= hp_btree_first(keydef, &info->last_pos)))
   {
     do
     {
@@ -191,9 +190,7 @@ static int check_one_rb_key(HP_INFO *info, uint keynr, ulong records,
       }
       else
 	found++;
-      key= tree_search_next(&keydef->rb_tree, &info->last_pos,
-			    offsetof(TREE_ELEMENT, left), 
-			    offsetof(TREE_ELEMENT, right));
+      key= hp_btree_next(keydef, &info->last_pos);
     } while (key);
   }
   if (found != records)
@@ -358,6 +358,17 @@ int ha_heap::rnd_pos(uchar * buf, uchar *pos)
   return error;
 }
 
+int ha_heap::remember_rnd_pos()
+{
+  heap_scan_remember(file);
+  return 0;
+}
+
+int ha_heap::restart_rnd_next(uchar *buf)
+{
+  return heap_scan_restart(file, buf);
+}
+
 void ha_heap::position(const uchar *record)
 {
   *(HEAP_PTR*) ref= heap_position(file);	// Ref is aligned
@@ -608,6 +619,7 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_BLOB_DESC *blob_descs;
   TABLE_SHARE *share= table_arg->s;
   bool found_real_auto_increment= 0;
 
@@ -616,11 +628,21 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   for (key= parts= 0; key < keys; key++)
     parts+= table_arg->key_info[key].user_defined_key_parts;
 
+  /* BLOB descriptors are allocated together with keys, freed with keydef */
   if (!(keydef= (HP_KEYDEF*) my_malloc(keys * sizeof(HP_KEYDEF) +
-				       parts * sizeof(HA_KEYSEG),
+				       parts * sizeof(HA_KEYSEG) +
+				       share->blob_fields *
+                                       sizeof(HP_BLOB_DESC),
 				       MYF(MY_WME | MY_THREAD_SPECIFIC))))
     return my_errno;
   seg= reinterpret_cast<HA_KEYSEG*>(keydef + keys);
+  blob_descs= reinterpret_cast<HP_BLOB_DESC*>(seg + parts);
+  for (uint i= 0; i < share->blob_fields; i++)
+  {
+    Field_blob *field= (Field_blob*) table_arg->field[share->blob_field[i]];
+    blob_descs[i].offset= (uint) field->offset(table_arg->record[0]);
+    blob_descs[i].packlength= field->pack_length_no_ptr();
+  }
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -639,7 +661,8 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
       break;
     case HA_KEY_ALG_BTREE:
       keydef[key].algorithm= HA_KEY_ALG_BTREE;
-      mem_per_row+=sizeof(TREE_ELEMENT)+pos->key_length+sizeof(char*);
+      /* Key and record pointer in a B+tree node that is 2/3 full */
+      mem_per_row+= (pos->key_length + sizeof(char*)) * 3 / 2;
       break;
     default:
       DBUG_ASSERT(0); // cannot happen
@@ -725,6 +748,8 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->keys= share->keys;
   hp_create_info->reclength= share->reclength;
   hp_create_info->keydef= keydef;
+  hp_create_info->blobs= share->blob_fields;
+  hp_create_info->blob_descs= blob_descs;
   return 0;
 }
 
@@ -820,6 +845,8 @@ int ha_heap::find_unique_row(uchar *record, uint unique_idx)
         records.
       */
       memcpy(record, file->current_ptr, (size_t) share->reclength);
+      if (share->blobs && hp_read_blobs(file, record))
+        DBUG_RETURN(-1);
 
       DBUG_RETURN(0); // found and position set
     }
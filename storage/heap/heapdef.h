@@ -20,7 +20,6 @@
 C_MODE_START
 #include <my_pthread.h>
 #include "heap.h"			/* Structs & some defines */
-#include "my_tree.h"
 
 /*
   When allocating keys /rows in the internal block structure, do it
@@ -52,12 +51,6 @@ typedef struct st_hp_hash_info
   ulong hash_of_key;
 } HASH_INFO;
 
-typedef struct {
-  HA_KEYSEG *keyseg;
-  uint key_length;
-  uint search_flag;
-} heap_rb_param;
-      
 	/* Prototypes for intern functions */
 
 extern HP_SHARE *hp_find_named_heap(const char *name);
@@ -101,6 +94,33 @@ extern void hp_clear(HP_SHARE *info);
 extern void hp_clear_keys(HP_SHARE *info);
 extern uint hp_rb_pack_key(HP_KEYDEF *keydef, uchar *key, const uchar *old,
                            key_part_map keypart_map);
+extern int hp_write_blobs(HP_SHARE *share, uchar *pos);
+extern void hp_free_blobs(HP_SHARE *share, uchar *pos);
+extern void hp_free_all_blobs(HP_SHARE *share);
+extern int hp_read_blobs(HP_INFO *info, uchar *record);
+extern int hp_blob_rec_cmp(HP_SHARE *share, const uchar *pos,
+                           const uchar *record);
+extern int hp_prepare_blob_update(HP_INFO *info, const uchar *old,
+                                  const uchar *heap_new);
+extern void hp_finish_blob_update(HP_INFO *info, uchar *pos,
+                                  const uchar *heap_new);
+extern void hp_abort_blob_update(HP_INFO *info, const uchar *heap_new);
+extern void hp_btree_init(HP_BTREE *tree, uint key_length, my_bool internal);
+extern void hp_btree_free(HP_BTREE *tree);
+extern int hp_btree_insert(HP_KEYDEF *keyinfo, const uchar *key,
+                           uint key_length);
+extern int hp_btree_delete(HP_KEYDEF *keyinfo, const uchar *key,
+                           uint key_length);
+extern uchar *hp_btree_search(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos,
+                              const uchar *key, uint key_length,
+                              uint nextflag, enum ha_rkey_function find_flag);
+extern uchar *hp_btree_first(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos);
+extern uchar *hp_btree_last(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos);
+extern uchar *hp_btree_next(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos);
+extern uchar *hp_btree_prev(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos);
+extern ha_rows hp_btree_records_before(HP_KEYDEF *keyinfo, const uchar *key,
+                                       uint key_length, uint nextflag,
+                                       my_bool after);
 
 extern mysql_mutex_t THR_LOCK_heap;
 
@@ -0,0 +1,380 @@
+/* Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Handling of BLOB columns in heap tables.
+
+  A stored record keeps the server record format, so a BLOB column is its
+  length followed by a pointer to the data. The data is kept outside of the
+  fixed-size record in a chunk of exactly the needed size, owned by the
+  table. Only the real length of each value is allocated, which is what
+  allows internal temporary tables with BLOB/TEXT columns to stay in memory.
+
+  The memory used for BLOB data is included in HP_SHARE::data_length and
+  is limited by max_table_size like the rest of the table. As record blocks
+  are allocated in advance, only the records in use are counted when
+  checking if a new BLOB value fits.
+
+  On read, the values are copied to a buffer owned by the HP_INFO and the
+  pointers in the returned record point to that buffer. This gives the same
+  lifetime rules as other engines: the data is valid until the next read
+  with the same handler, even if the row is updated or deleted meanwhile
+  (needed for triggers and row based replication).
+*/
+
+#include "heapdef.h"
+
+static inline uint hp_blob_length(const HP_BLOB_DESC *blob, const uchar *rec)
+{
+  const uchar *pos= rec + blob->offset;
+  switch (blob->packlength) {
+  case 1:
+    return (uint) *pos;
+  case 2:
+    return uint2korr(pos);
+  case 3:
+    return uint3korr(pos);
+  case 4:
+    return uint4korr(pos);
+  }
+  DBUG_ASSERT(0);
+  return 0;
+}
+
+
+static inline uchar *hp_blob_data(const HP_BLOB_DESC *blob, const uchar *rec)
+{
+  uchar *data;
+  memcpy(&data, rec + blob->offset + blob->packlength, sizeof(data));
+  return data;
+}
+
+
+static inline void hp_set_blob_data(const HP_BLOB_DESC *blob, uchar *rec,
+                                    uchar *data)
+{
+  memcpy(rec + blob->offset + blob->packlength, &data, sizeof(data));
+}
+
+
+/*
+  Allocate a table-owned copy of a BLOB value
+
+  SYNOPSIS
+    hp_alloc_blob()
+    share               Heap table
+    data                Value to copy
+    length              Length of value, > 0
+    check_size          Check that the records in use and the BLOB data
+                        don't grow over max_table_size
+
+  RETURN
+    Pointer to the copy, 0 on error (my_errno is set)
+*/
+
+static uchar *hp_alloc_blob(HP_SHARE *share, const uchar *data, uint length,
+                            my_bool check_size)
+{
+  uchar *copy;
+  if (check_size &&
+      (ulonglong) share->block.recbuffer * (share->records + share->deleted) +
+      share->blob_length + share->index_length + length >
+      share->max_table_size)
+  {
+    my_errno= HA_ERR_RECORD_FILE_FULL;
+    return 0;
+  }
+  if (!(copy= (uchar*) my_malloc(length,
+                                 MYF(share->internal ?
+                                     MY_THREAD_SPECIFIC : 0))))
+  {
+    my_errno= HA_ERR_OUT_OF_MEM;
+    return 0;
+  }
+  memcpy(copy, data, length);
+  share->data_length+= length;
+  share->blob_length+= length;
+  return copy;
+}
+
+
+static inline void hp_free_blob(HP_SHARE *share, uchar *data, uint length)
+{
+  if (data)
+  {
+    share->data_length-= length;
+    share->blob_length-= length;
+    my_free(data);
+  }
+}
+
+
+/*
+  Make the BLOB columns of a newly stored record point to table owned data
+
+  SYNOPSIS
+    hp_write_blobs()
+    share               Heap table
+    pos                 Stored record, a copy of the record given by the
+                        caller, so it still points to the caller's data
+
+  RETURN
+    0   ok
+    #   error. Nothing is allocated.
+*/
+
+int hp_write_blobs(HP_SHARE *share, uchar *pos)
+{
+  HP_BLOB_DESC *blob, *end;
+  DBUG_ENTER("hp_write_blobs");
+
+  for (blob= share->blob_descs, end= blob + share->blobs; blob < end; blob++)
+  {
+    uint length= hp_blob_length(blob, pos);
+    uchar *copy= 0;
+    if (length && !(copy= hp_alloc_blob(share, hp_blob_data(blob, pos),
+                                        length, 1)))
+      goto err;
+    hp_set_blob_data(blob, pos, copy);
+  }
+  DBUG_RETURN(0);
+
+err:
+  while (blob-- != share->blob_descs)
+    hp_free_blob(share, hp_blob_data(blob, pos), hp_blob_length(blob, pos));
+  DBUG_RETURN(my_errno);
+}
+
+
+/*
+  Free the BLOB data of a stored record
+*/
+
+void hp_free_blobs(HP_SHARE *share, uchar *pos)
+{
+  HP_BLOB_DESC *blob, *end;
+  for (blob= share->blob_descs, end= blob + share->blobs; blob < end; blob++)
+  {
+    hp_free_blob(share, hp_blob_data(blob, pos), hp_blob_length(blob, pos));
+    hp_set_blob_data(blob, pos, 0);
+  }
+}
+
+
+/*
+  Free the BLOB data of all records in the table.
+  Used when the table is cleared or dropped.
+*/
+
+void hp_free_all_blobs(HP_SHARE *share)
+{
+  ulong pos, records= share->records + share->deleted;
+  DBUG_ENTER("hp_free_all_blobs");
+
+  for (pos= 0; pos < records; pos++)
+  {
+    uchar *rec= hp_find_block(&share->block, pos);
+    if (rec[share->visible])
+      hp_free_blobs(share, rec);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Copy the BLOB data of a record that was just read to the row buffer
+
+  SYNOPSIS
+    hp_read_blobs()
+    info                Heap table handler
+    record              Record that was copied from the table. Its BLOB
+                        columns are changed to point to info->blob_buffer.
+
+  RETURN
+    0   ok
+    #   error
+*/
+
+int hp_read_blobs(HP_INFO *info, uchar *record)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *blob, *end= share->blob_descs + share->blobs;
+  size_t total_length= 0;
+  uchar *to;
+
+  for (blob= share->blob_descs; blob < end; blob++)
+    total_length+= hp_blob_length(blob, record);
+
+  if (total_length > info->blob_buffer_length)
+  {
+    uchar *buffer;
+    if (!(buffer= (uchar*) my_malloc(total_length,
+                                     MYF(share->internal ?
+                                         MY_THREAD_SPECIFIC : 0))))
+      return my_errno= HA_ERR_OUT_OF_MEM;
+    my_free(info->blob_buffer);
+    info->blob_buffer= buffer;
+    info->blob_buffer_length= total_length;
+  }
+
+  for (blob= share->blob_descs, to= info->blob_buffer; blob < end; blob++)
+  {
+    uint length= hp_blob_length(blob, record);
+    if (length)
+    {
+      memcpy(to, hp_blob_data(blob, record), length);
+      hp_set_blob_data(blob, record, to);
+      to+= length;
+    }
+  }
+  return 0;
+}
+
+
+/*
+  Compare a stored record with a record read from it
+
+  SYNOPSIS
+    hp_blob_rec_cmp()
+    share               Heap table
+    pos                 Stored record
+    record              Record to compare with, its BLOB columns may point
+                        to a copy of the stored data
+
+  NOTES
+    BLOB columns are compared by value, the rest of the record byte by byte.
+    BLOB descriptors are in record order.
+
+  RETURN
+    0   equal
+    1   different
+*/
+
+int hp_blob_rec_cmp(HP_SHARE *share, const uchar *pos, const uchar *record)
+{
+  HP_BLOB_DESC *blob, *end= share->blob_descs + share->blobs;
+  uint offset= 0;
+
+  for (blob= share->blob_descs; blob < end; blob++)
+  {
+    uint length= hp_blob_length(blob, pos);
+    if (memcmp(pos + offset, record + offset,
+               blob->offset + blob->packlength - offset) ||
+        (length &&
+         memcmp(hp_blob_data(blob, pos), hp_blob_data(blob, record), length)))
+      return 1;
+    offset= blob->offset + blob->packlength + sizeof(uchar*);
+  }
+  return memcmp(pos + offset, record + offset, share->reclength - offset) != 0;
+}
+
+
+/*
+  Allocate the BLOB values of an updated row, before anything is changed
+
+  SYNOPSIS
+    hp_prepare_blob_update()
+    info                Heap table handler, positioned on the updated row
+    old                 Old record as given to heap_update()
+    heap_new            New record as given to heap_update()
+
+  NOTES
+    A value is considered unchanged and the stored data is reused if the
+    new record points to the same data as the old one. For every BLOB
+    column info->blob_copies is set to the data to store with the new
+    record.
+    Table size is not checked for internal temporary tables, as an update
+    of them can't be converted to a write to an on-disk table.
+
+  RETURN
+    0   ok
+    #   error. Nothing is allocated.
+*/
+
+int hp_prepare_blob_update(HP_INFO *info, const uchar *old,
+                           const uchar *heap_new)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *blob, *end;
+  uchar **copy= info->blob_copies;
+  DBUG_ENTER("hp_prepare_blob_update");
+
+  for (blob= share->blob_descs, end= blob + share->blobs; blob < end;
+       blob++, copy++)
+  {
+    uint length= hp_blob_length(blob, heap_new);
+    uchar *data= hp_blob_data(blob, heap_new);
+    if (length == hp_blob_length(blob, old) && data == hp_blob_data(blob, old))
+      *copy= hp_blob_data(blob, info->current_ptr);
+    else if (!length)
+      *copy= 0;
+    else if (!(*copy= hp_alloc_blob(share, data, length, !share->internal)))
+    {
+      end= blob;
+      for (blob= share->blob_descs, copy= info->blob_copies; blob < end;
+           blob++, copy++)
+      {
+        if (*copy != hp_blob_data(blob, info->current_ptr))
+          hp_free_blob(share, *copy, hp_blob_length(blob, heap_new));
+      }
+      DBUG_RETURN(my_errno);
+    }
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Store the new record of an update, freeing replaced BLOB values
+*/
+
+void hp_finish_blob_update(HP_INFO *info, uchar *pos, const uchar *heap_new)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *blob, *end= share->blob_descs + share->blobs;
+  uchar **copy;
+
+  for (blob= share->blob_descs, copy= info->blob_copies; blob < end;
+       blob++, copy++)
+  {
+    uchar *data= hp_blob_data(blob, pos);
+    if (*copy != data)
+      hp_free_blob(share, data, hp_blob_length(blob, pos));
+  }
+  memcpy(pos, heap_new, (size_t) share->reclength);
+  for (blob= share->blob_descs, copy= info->blob_copies; blob < end;
+       blob++, copy++)
+    hp_set_blob_data(blob, pos, *copy);
+}
+
+
+/*
+  Free the BLOB values allocated by hp_prepare_blob_update() for an
+  update that failed
+*/
+
+void hp_abort_blob_update(HP_INFO *info, const uchar *heap_new)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *blob, *end= share->blob_descs + share->blobs;
+  uchar **copy;
+
+  for (blob= share->blob_descs, copy= info->blob_copies; blob < end;
+       blob++, copy++)
+  {
+    if (*copy != hp_blob_data(blob, info->current_ptr))
+      hp_free_blob(share, *copy, hp_blob_length(blob, heap_new));
+  }
+}
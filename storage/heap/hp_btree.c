@@ -0,0 +1,808 @@
+/* Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  B+tree used for BTREE keys of heap tables.
+
+  A key is stored as made by hp_rb_make_key(): the packed key followed by
+  the record pointer. All keys of a tree are thus unique and are ordered
+  by key value and then by record position.
+
+  Every key gets a slot of the max key length in a node, so a node is
+  searched with a binary search over consecutive memory, instead of
+  following one pointer per key as in the red-black tree of mysys.
+  Leaves hold the keys and are linked in key order for index scans. Inner
+  nodes hold separator keys, the children and the number of keys under
+  each child, which gives exact positions for records_in_range().
+
+  Child i of an inner node holds the keys >= separator i-1 and
+  < separator i. A separator is a copy of a key and is not changed when
+  that key is deleted. Leaves are never empty, except that an empty tree
+  has no nodes at all. A node that gets less than half full on delete is
+  merged with a neighbour if they fit in one node.
+
+  Every node has room for one key more than its max number of keys, so a
+  key can always be added before the node is split. The nodes needed for
+  the splits are allocated before an insert, so an insert either fails
+  without changes or completes.
+
+  A position (HP_BTREE_POS) is a leaf and a slot. Keys move between slots
+  and nodes on every change of the tree, so a position also holds a copy
+  of its key and the version of the tree. If the tree has changed, the
+  next/prev key is searched for with the copy.
+*/
+
+#include "heapdef.h"
+
+/*
+  Size of a node. Bigger nodes give fewer levels, but more keys are moved
+  on insert and delete.
+*/
+#define HP_BTREE_NODE_SIZE 1024
+#define HP_BTREE_MIN_KEYS  4
+
+typedef struct st_hp_btree_node
+{
+  struct st_hp_btree_node *prev, *next;	/* Leaves in key order */
+  uint keys;				/* Number of keys in node */
+  uint level;				/* 0 for leaves */
+} HP_BTREE_NODE;
+
+/*
+  Layout of a node after the header:
+  leaf:  leaf_keys + 1 key slots
+  inner: node_keys + 1 key slots, node_keys + 2 children and
+         node_keys + 2 record counts
+*/
+#define node_key(T, N, I) ((uchar*) ((N) + 1) + (size_t) (I) * (T)->key_slot)
+#define node_child(T, N) ((HP_BTREE_NODE**) node_key(T, N, (T)->node_keys + 1))
+#define node_records(T, N) ((ulong*) (node_child(T, N) + (T)->node_keys + 2))
+
+
+/*
+  Initialize an empty tree
+
+  SYNOPSIS
+    hp_btree_init()
+    tree                Tree
+    key_length          Max length of a key, including the record pointer
+    internal            Set for internal temporary tables
+*/
+
+void hp_btree_init(HP_BTREE *tree, uint key_length, my_bool internal)
+{
+  uint child_length= sizeof(HP_BTREE_NODE*) + sizeof(ulong);
+  bzero((char*) tree, sizeof(*tree));
+  tree->key_length= key_length;
+  tree->key_slot= MY_ALIGN(key_length, sizeof(HP_BTREE_NODE*));
+  tree->node_size= MY_MAX(HP_BTREE_NODE_SIZE,
+                          sizeof(HP_BTREE_NODE) +
+                          (HP_BTREE_MIN_KEYS + 1) *
+                          (tree->key_slot + child_length) + child_length);
+  tree->leaf_keys= (tree->node_size - sizeof(HP_BTREE_NODE)) /
+                   tree->key_slot - 1;
+  tree->node_keys= (tree->node_size - sizeof(HP_BTREE_NODE) - child_length) /
+                   (tree->key_slot + child_length) - 1;
+  tree->my_flags= internal ? MY_THREAD_SPECIFIC : 0;
+}
+
+
+/*
+  Make sure that there are at least 'count' free nodes
+*/
+
+static my_bool reserve_nodes(HP_BTREE *tree, uint count)
+{
+  while (tree->free_count < count)
+  {
+    HP_BTREE_NODE *node;
+    if (!(node= (HP_BTREE_NODE*) my_malloc(tree->node_size,
+                                           MYF(tree->my_flags))))
+      return 1;
+    node->next= tree->free_nodes;
+    tree->free_nodes= node;
+    tree->free_count++;
+    tree->allocated+= tree->node_size;
+  }
+  return 0;
+}
+
+
+static HP_BTREE_NODE *new_node(HP_BTREE *tree, uint level)
+{
+  HP_BTREE_NODE *node= tree->free_nodes;
+  DBUG_ASSERT(node);
+  tree->free_nodes= node->next;
+  tree->free_count--;
+  node->prev= node->next= 0;
+  node->keys= 0;
+  node->level= level;
+  return node;
+}
+
+
+static void free_node(HP_BTREE *tree, HP_BTREE_NODE *node)
+{
+  tree->allocated-= tree->node_size;
+  my_free(node);
+}
+
+
+/*
+  Free a node and its children, unlinking the freed leaves
+*/
+
+static void free_subtree(HP_BTREE *tree, HP_BTREE_NODE *node)
+{
+  if (node->level)
+  {
+    HP_BTREE_NODE **child= node_child(tree, node);
+    uint i;
+    for (i= 0; i <= node->keys; i++)
+      free_subtree(tree, child[i]);
+  }
+  else
+  {
+    if (node->prev)
+      node->prev->next= node->next;
+    else
+      tree->first= node->next;
+    if (node->next)
+      node->next->prev= node->prev;
+    else
+      tree->last= node->prev;
+  }
+  free_node(tree, node);
+}
+
+
+/*
+  Remove all keys and free all memory of a tree
+*/
+
+void hp_btree_free(HP_BTREE *tree)
+{
+  HP_BTREE_NODE *node;
+  if (tree->root)
+    free_subtree(tree, tree->root);
+  while ((node= tree->free_nodes))
+  {
+    tree->free_nodes= node->next;
+    free_node(tree, node);
+  }
+  DBUG_ASSERT(tree->allocated == 0);
+  tree->root= tree->first= tree->last= 0;
+  tree->free_count= 0;
+  tree->records= 0;
+  tree->version++;
+}
+
+
+/* Number of keys under a node */
+
+static ulong node_count(HP_BTREE *tree, HP_BTREE_NODE *node)
+{
+  ulong count, *records;
+  uint i;
+  if (!node->level)
+    return node->keys;
+  records= node_records(tree, node);
+  for (i= 0, count= 0; i <= node->keys; i++)
+    count+= records[i];
+  return count;
+}
+
+
+/*
+  Find the number of keys in a node that are < key, or <= key if 'after'
+  is set. For an inner node this is the child to continue in.
+*/
+
+static uint node_search(HP_BTREE *tree, HA_KEYSEG *keyseg,
+                        HP_BTREE_NODE *node, const uchar *key,
+                        uint key_length, uint nextflag, my_bool after)
+{
+  uint low= 0, high= node->keys, not_used[2];
+  while (low < high)
+  {
+    uint mid= (low + high) / 2;
+    int cmp= ha_key_cmp(keyseg, node_key(tree, node, mid), key, key_length,
+                        nextflag, not_used);
+    if (cmp < 0 || (cmp == 0 && after))
+      low= mid + 1;
+    else
+      high= mid;
+  }
+  return low;
+}
+
+
+/*
+  Split a leaf that has one key too many. Returns the new right leaf.
+  If the last key of the tree was added, the old leaf is kept full, so
+  that keys inserted in order fill the leaves.
+*/
+
+static HP_BTREE_NODE *split_leaf(HP_BTREE *tree, HP_BTREE_NODE *leaf,
+                                 uint pos)
+{
+  HP_BTREE_NODE *right= new_node(tree, 0);
+  uint keep= (!leaf->next && pos == leaf->keys - 1) ? pos : leaf->keys / 2;
+
+  right->keys= leaf->keys - keep;
+  memcpy(node_key(tree, right, 0), node_key(tree, leaf, keep),
+         (size_t) right->keys * tree->key_slot);
+  leaf->keys= keep;
+  right->prev= leaf;
+  right->next= leaf->next;
+  if (leaf->next)
+    leaf->next->prev= right;
+  else
+    tree->last= right;
+  leaf->next= right;
+  return right;
+}
+
+
+/*
+  Split an inner node that has one key too many. Returns the new right
+  node. The middle key is left after the last key of the old node, from
+  where the caller moves it to the parent.
+*/
+
+static HP_BTREE_NODE *split_node(HP_BTREE *tree, HP_BTREE_NODE *node)
+{
+  HP_BTREE_NODE *right= new_node(tree, node->level);
+  uint keep= node->keys / 2;
+
+  right->keys= node->keys - keep - 1;
+  memcpy(node_key(tree, right, 0), node_key(tree, node, keep + 1),
+         (size_t) right->keys * tree->key_slot);
+  memcpy(node_child(tree, right), node_child(tree, node) + keep + 1,
+         (right->keys + 1) * sizeof(HP_BTREE_NODE*));
+  memcpy(node_records(tree, right), node_records(tree, node) + keep + 1,
+         (right->keys + 1) * sizeof(ulong));
+  node->keys= keep;
+  return right;
+}
+
+
+/* Key to add to the parent when 'left' was split to 'left' and 'right' */
+
+static inline uchar *split_key(HP_BTREE *tree, HP_BTREE_NODE *left,
+                               HP_BTREE_NODE *right)
+{
+  return right->level ? node_key(tree, left, left->keys) :
+                        node_key(tree, right, 0);
+}
+
+
+/*
+  Check if a unique key has the same value as the key before or after
+  the place where it is inserted. Keys with NULL are never equal.
+*/
+
+static my_bool is_duplicate(HP_KEYDEF *keyinfo, HP_BTREE_NODE *leaf,
+                            uint pos, const uchar *key, uint key_length)
+{
+  HP_BTREE *tree= &keyinfo->btree;
+  const uchar *prev= 0, *next= 0;
+  uint not_used[2];
+
+  if (pos)
+    prev= node_key(tree, leaf, pos - 1);
+  else if (leaf->prev)
+    prev= node_key(tree, leaf->prev, leaf->prev->keys - 1);
+  if (pos < leaf->keys)
+    next= node_key(tree, leaf, pos);
+  else if (leaf->next)
+    next= node_key(tree, leaf->next, 0);
+
+  return ((prev &&
+           !ha_key_cmp(keyinfo->seg, prev, key, key_length,
+                       SEARCH_FIND | SEARCH_UPDATE | SEARCH_INSERT,
+                       not_used)) ||
+          (next &&
+           !ha_key_cmp(keyinfo->seg, next, key, key_length,
+                       SEARCH_FIND | SEARCH_UPDATE | SEARCH_INSERT,
+                       not_used)));
+}
+
+
+/*
+  Insert a key under a node. If the node was split, *split is set to
+  the new right node.
+*/
+
+static int insert_key(HP_KEYDEF *keyinfo, HP_BTREE_NODE *node,
+                      const uchar *key, uint key_length,
+                      HP_BTREE_NODE **split)
+{
+  HP_BTREE *tree= &keyinfo->btree;
+  uint pos= node_search(tree, keyinfo->seg, node, key, key_length,
+                        SEARCH_SAME, 1);
+  *split= 0;
+
+  if (node->level)
+  {
+    HP_BTREE_NODE **child= node_child(tree, node), *right;
+    ulong *records= node_records(tree, node);
+    int error;
+
+    if ((error= insert_key(keyinfo, child[pos], key, key_length, &right)))
+      return error;
+    records[pos]++;
+    if (!right)
+      return 0;
+
+    memmove(node_key(tree, node, pos + 1), node_key(tree, node, pos),
+            (size_t) (node->keys - pos) * tree->key_slot);
+    memcpy(node_key(tree, node, pos), split_key(tree, child[pos], right),
+           tree->key_slot);
+    memmove(child + pos + 2, child + pos + 1,
+            (node->keys - pos) * sizeof(*child));
+    memmove(records + pos + 2, records + pos + 1,
+            (node->keys - pos) * sizeof(*records));
+    child[pos + 1]= right;
+    records[pos + 1]= node_count(tree, right);
+    records[pos]-= records[pos + 1];
+    if (++node->keys > tree->node_keys)
+      *split= split_node(tree, node);
+  }
+  else
+  {
+    if ((keyinfo->flag & HA_NOSAME) &&
+        is_duplicate(keyinfo, node, pos, key, key_length))
+      return HA_ERR_FOUND_DUPP_KEY;
+    memmove(node_key(tree, node, pos + 1), node_key(tree, node, pos),
+            (size_t) (node->keys - pos) * tree->key_slot);
+    memcpy(node_key(tree, node, pos), key, key_length + sizeof(uchar*));
+    if (++node->keys > tree->leaf_keys)
+      *split= split_leaf(tree, node, pos);
+  }
+  return 0;
+}
+
+
+/*
+  Insert a key into a tree
+
+  SYNOPSIS
+    hp_btree_insert()
+    keyinfo             BTREE key
+    key                 Key made by hp_rb_make_key()
+    key_length          Length of key, without the record pointer
+
+  RETURN
+    0                           ok
+    HA_ERR_FOUND_DUPP_KEY       Duplicate value of a unique key
+    HA_ERR_OUT_OF_MEM           Out of memory
+*/
+
+int hp_btree_insert(HP_KEYDEF *keyinfo, const uchar *key, uint key_length)
+{
+  HP_BTREE *tree= &keyinfo->btree;
+  HP_BTREE_NODE *right;
+  int error;
+
+  /* One split per level and a new root */
+  if (reserve_nodes(tree, tree->root ? tree->root->level + 2 : 1))
+    return HA_ERR_OUT_OF_MEM;
+  if (!tree->root)
+    tree->root= tree->first= tree->last= new_node(tree, 0);
+
+  if ((error= insert_key(keyinfo, tree->root, key, key_length, &right)))
+    return error;
+  if (right)
+  {
+    HP_BTREE_NODE *root= new_node(tree, right->level + 1);
+    memcpy(node_key(tree, root, 0), split_key(tree, tree->root, right),
+           tree->key_slot);
+    node_child(tree, root)[0]= tree->root;
+    node_child(tree, root)[1]= right;
+    node_records(tree, root)[0]= node_count(tree, tree->root);
+    node_records(tree, root)[1]= node_count(tree, right);
+    root->keys= 1;
+    tree->root= root;
+  }
+  tree->records++;
+  tree->version++;
+  return 0;
+}
+
+
+/*
+  Remove child 'pos' of an inner node, freeing it. Used for children
+  without keys.
+*/
+
+static void remove_child(HP_BTREE *tree, HP_BTREE_NODE *node, uint pos)
+{
+  HP_BTREE_NODE **child= node_child(tree, node);
+  ulong *records= node_records(tree, node);
+  uint key= pos ? pos - 1 : 0;
+
+  free_subtree(tree, child[pos]);
+  memmove(node_key(tree, node, key), node_key(tree, node, key + 1),
+          (size_t) (node->keys - key - 1) * tree->key_slot);
+  memmove(child + pos, child + pos + 1, (node->keys - pos) * sizeof(*child));
+  memmove(records + pos, records + pos + 1,
+          (node->keys - pos) * sizeof(*records));
+  node->keys--;
+}
+
+
+/*
+  Merge child 'pos' + 1 of an inner node into child 'pos', if they fit
+  in one node
+*/
+
+static void merge_children(HP_BTREE *tree, HP_BTREE_NODE *node, uint pos)
+{
+  HP_BTREE_NODE **child= node_child(tree, node);
+  HP_BTREE_NODE *left= child[pos], *right= child[pos + 1];
+  ulong *records= node_records(tree, node);
+
+  if (left->level)
+  {
+    if (left->keys + right->keys + 1 > tree->node_keys)
+      return;
+    memcpy(node_key(tree, left, left->keys), node_key(tree, node, pos),
+           tree->key_slot);
+    memcpy(node_key(tree, left, left->keys + 1), node_key(tree, right, 0),
+           (size_t) right->keys * tree->key_slot);
+    memcpy(node_child(tree, left) + left->keys + 1, node_child(tree, right),
+           (right->keys + 1) * sizeof(HP_BTREE_NODE*));
+    memcpy(node_records(tree, left) + left->keys + 1,
+           node_records(tree, right), (right->keys + 1) * sizeof(ulong));
+    left->keys+= right->keys + 1;
+  }
+  else
+  {
+    if (left->keys + right->keys > tree->leaf_keys)
+      return;
+    memcpy(node_key(tree, left, left->keys), node_key(tree, right, 0),
+           (size_t) right->keys * tree->key_slot);
+    left->keys+= right->keys;
+    left->next= right->next;
+    if (right->next)
+      right->next->prev= left;
+    else
+      tree->last= left;
+  }
+  records[pos]+= records[pos + 1];
+  memmove(node_key(tree, node, pos), node_key(tree, node, pos + 1),
+          (size_t) (node->keys - pos - 1) * tree->key_slot);
+  memmove(child + pos + 1, child + pos + 2,
+          (node->keys - pos - 1) * sizeof(*child));
+  memmove(records + pos + 1, records + pos + 2,
+          (node->keys - pos - 1) * sizeof(*records));
+  node->keys--;
+  free_node(tree, right);
+}
+
+
+/*
+  Delete a key under a node. Returns 1 if the key was not found.
+*/
+
+static int delete_key(HP_KEYDEF *keyinfo, HP_BTREE_NODE *node,
+                      const uchar *key, uint key_length)
+{
+  HP_BTREE *tree= &keyinfo->btree;
+  uint pos, not_used[2];
+
+  if (node->level)
+  {
+    HP_BTREE_NODE **child= node_child(tree, node);
+    ulong *records= node_records(tree, node);
+    uint max_keys;
+
+    pos= node_search(tree, keyinfo->seg, node, key, key_length,
+                     SEARCH_SAME, 1);
+    if (delete_key(keyinfo, child[pos], key, key_length))
+      return 1;
+    if (!--records[pos])
+    {
+      /* An empty child is freed, unless it's the only one */
+      if (node->keys)
+        remove_child(tree, node, pos);
+      return 0;
+    }
+    max_keys= child[pos]->level ? tree->node_keys : tree->leaf_keys;
+    if (child[pos]->keys < max_keys / 2)
+    {
+      if (pos < node->keys)
+        merge_children(tree, node, pos);
+      else if (pos)
+        merge_children(tree, node, pos - 1);
+    }
+    return 0;
+  }
+
+  pos= node_search(tree, keyinfo->seg, node, key, key_length, SEARCH_SAME, 0);
+  if (pos == node->keys ||
+      ha_key_cmp(keyinfo->seg, node_key(tree, node, pos), key, key_length,
+                 SEARCH_SAME, not_used))
+    return 1;
+  node->keys--;
+  memmove(node_key(tree, node, pos), node_key(tree, node, pos + 1),
+          (size_t) (node->keys - pos) * tree->key_slot);
+  return 0;
+}
+
+
+/*
+  Delete a key from a tree
+
+  SYNOPSIS
+    hp_btree_delete()
+    keyinfo             BTREE key
+    key                 Key made by hp_rb_make_key()
+    key_length          Length of key, without the record pointer
+
+  RETURN
+    0   ok
+    1   key not found
+*/
+
+int hp_btree_delete(HP_KEYDEF *keyinfo, const uchar *key, uint key_length)
+{
+  HP_BTREE *tree= &keyinfo->btree;
+  HP_BTREE_NODE *root= tree->root;
+
+  if (!root || delete_key(keyinfo, root, key, key_length))
+    return 1;
+  tree->version++;
+  if (!--tree->records)
+  {
+    free_subtree(tree, root);
+    tree->root= 0;
+    return 0;
+  }
+  while (root->level && !root->keys)
+  {
+    tree->root= node_child(tree, root)[0];
+    free_node(tree, root);
+    root= tree->root;
+  }
+  return 0;
+}
+
+
+/*
+  Find the leaf and slot of the first key >= key, or > key if 'after'
+  is set. The slot is the number of keys in the leaf if the key is after
+  all keys in it.
+*/
+
+static HP_BTREE_NODE *find_leaf(HP_KEYDEF *keyinfo, const uchar *key,
+                                uint key_length, uint nextflag,
+                                my_bool after, uint *slot)
+{
+  HP_BTREE *tree= &keyinfo->btree;
+  HP_BTREE_NODE *node= tree->root;
+
+  if (!node)
+    return 0;
+  while (node->level)
+    node= node_child(tree, node)[node_search(tree, keyinfo->seg, node, key,
+                                             key_length, nextflag, after)];
+  *slot= node_search(tree, keyinfo->seg, node, key, key_length, nextflag,
+                     after);
+  return node;
+}
+
+
+/* Move to the slot itself, or to the next leaf if the slot is after the end */
+
+static inline HP_BTREE_NODE *slot_or_next(HP_BTREE_NODE *leaf, uint *slot)
+{
+  if (leaf && *slot == leaf->keys)
+  {
+    leaf= leaf->next;
+    *slot= 0;
+  }
+  return leaf;
+}
+
+
+/* Move to the slot before */
+
+static inline HP_BTREE_NODE *slot_before(HP_BTREE_NODE *leaf, uint *slot)
+{
+  if (leaf && !*slot && (leaf= leaf->prev))
+    *slot= leaf->keys;
+  if (leaf)
+    (*slot)--;
+  return leaf;
+}
+
+
+/* Set a position and return its key, or 0 if there is no such key */
+
+static uchar *set_pos(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos,
+                      HP_BTREE_NODE *leaf, uint slot)
+{
+  uchar *key;
+  if (!(pos->leaf= leaf))
+    return 0;
+  pos->slot= slot;
+  pos->version= keyinfo->btree.version;
+  key= node_key(&keyinfo->btree, leaf, slot);
+  memcpy(pos->key, key, (*keyinfo->get_key_length)(keyinfo, key) +
+         sizeof(uchar*));
+  return key;
+}
+
+
+/*
+  Search for a key
+
+  SYNOPSIS
+    hp_btree_search()
+    keyinfo             BTREE key
+    pos                 Set to the found key
+    key                 Packed key to search for
+    key_length          Length of key
+    nextflag            Flags for ha_key_cmp()
+    find_flag           How to search, as for tree_search_key():
+                        HA_READ_KEY_OR_PREV finds the first equal key
+
+  RETURN
+    Found key, 0 if not found
+*/
+
+uchar *hp_btree_search(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos,
+                       const uchar *key, uint key_length, uint nextflag,
+                       enum ha_rkey_function find_flag)
+{
+  HP_BTREE_NODE *leaf, *next;
+  uint slot, next_slot, not_used[2];
+
+  switch (find_flag) {
+  case HA_READ_KEY_EXACT:
+  case HA_READ_KEY_OR_NEXT:
+  case HA_READ_KEY_OR_PREV:
+  case HA_READ_BEFORE_KEY:
+    leaf= find_leaf(keyinfo, key, key_length, nextflag, 0, &slot);
+    break;
+  case HA_READ_AFTER_KEY:
+  case HA_READ_PREFIX_LAST:
+  case HA_READ_PREFIX_LAST_OR_PREV:
+    leaf= find_leaf(keyinfo, key, key_length, nextflag, 1, &slot);
+    break;
+  default:
+    return set_pos(keyinfo, pos, 0, 0);
+  }
+
+  switch (find_flag) {
+  case HA_READ_KEY_EXACT:
+  case HA_READ_KEY_OR_PREV:
+    next_slot= slot;
+    if ((next= slot_or_next(leaf, &next_slot)) &&
+        !ha_key_cmp(keyinfo->seg, node_key(&keyinfo->btree, next, next_slot),
+                    key, key_length, nextflag, not_used))
+    {
+      leaf= next;
+      slot= next_slot;
+    }
+    else if (find_flag == HA_READ_KEY_EXACT)
+      leaf= 0;
+    else
+      leaf= slot_before(leaf, &slot);
+    break;
+  case HA_READ_KEY_OR_NEXT:
+  case HA_READ_AFTER_KEY:
+    leaf= slot_or_next(leaf, &slot);
+    break;
+  case HA_READ_BEFORE_KEY:
+  case HA_READ_PREFIX_LAST_OR_PREV:
+    leaf= slot_before(leaf, &slot);
+    break;
+  case HA_READ_PREFIX_LAST:
+    if ((leaf= slot_before(leaf, &slot)) &&
+        ha_key_cmp(keyinfo->seg, node_key(&keyinfo->btree, leaf, slot),
+                   key, key_length, nextflag, not_used))
+      leaf= 0;
+    break;
+  default:
+    break;
+  }
+  return set_pos(keyinfo, pos, leaf, slot);
+}
+
+
+/* Find the first key */
+
+uchar *hp_btree_first(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos)
+{
+  return set_pos(keyinfo, pos, keyinfo->btree.first, 0);
+}
+
+
+/* Find the last key */
+
+uchar *hp_btree_last(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos)
+{
+  HP_BTREE_NODE *leaf= keyinfo->btree.last;
+  return set_pos(keyinfo, pos, leaf, leaf ? leaf->keys - 1 : 0);
+}
+
+
+/*
+  Find the key after a position. The position must be set.
+*/
+
+uchar *hp_btree_next(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos)
+{
+  HP_BTREE_NODE *leaf= pos->leaf;
+  uint slot= pos->slot + 1;
+
+  DBUG_ASSERT(leaf);
+  if (pos->version != keyinfo->btree.version)
+    leaf= find_leaf(keyinfo, pos->key,
+                    (*keyinfo->get_key_length)(keyinfo, pos->key),
+                    SEARCH_SAME, 1, &slot);
+  leaf= slot_or_next(leaf, &slot);
+  return set_pos(keyinfo, pos, leaf, slot);
+}
+
+
+/*
+  Find the key before a position. The position must be set.
+*/
+
+uchar *hp_btree_prev(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos)
+{
+  HP_BTREE_NODE *leaf= pos->leaf;
+  uint slot= pos->slot;
+
+  DBUG_ASSERT(leaf);
+  if (pos->version != keyinfo->btree.version)
+    leaf= find_leaf(keyinfo, pos->key,
+                    (*keyinfo->get_key_length)(keyinfo, pos->key),
+                    SEARCH_SAME, 0, &slot);
+  leaf= slot_before(leaf, &slot);
+  return set_pos(keyinfo, pos, leaf, slot);
+}
+
+
+/*
+  Number of keys < key, or <= key if 'after' is set
+*/
+
+ha_rows hp_btree_records_before(HP_KEYDEF *keyinfo, const uchar *key,
+                                uint key_length, uint nextflag,
+                                my_bool after)
+{
+  HP_BTREE *tree= &keyinfo->btree;
+  HP_BTREE_NODE *node= tree->root;
+  ha_rows records= 0;
+
+  if (!node)
+    return 0;
+  while (node->level)
+  {
+    uint i, pos= node_search(tree, keyinfo->seg, node, key, key_length,
+                             nextflag, after);
+    ulong *child_records= node_records(tree, node);
+    for (i= 0; i < pos; i++)
+      records+= child_records[i];
+    node= node_child(tree, node)[pos];
+  }
+  return records + node_search(tree, keyinfo->seg, node, key, key_length,
+                               nextflag, after);
+}
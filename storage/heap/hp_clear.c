@@ -31,6 +31,8 @@ void hp_clear(HP_SHARE *info)
 {
   DBUG_ENTER("hp_clear");
 
+  if (info->blobs)
+    hp_free_all_blobs(info);
   if (info->block.levels)
     (void) hp_free_level(&info->block,info->block.levels,info->block.root,
 			(uchar*) 0);
@@ -91,7 +93,7 @@ void hp_clear_keys(HP_SHARE *info)
     HP_KEYDEF *keyinfo = info->keydef + key;
     if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
     {
-      delete_tree(&keyinfo->rb_tree, 0);
+      hp_btree_free(&keyinfo->btree);
     }
     else
     {
@@ -16,7 +16,6 @@
 
 #include "heapdef.h"
 
-static int keys_compare(heap_rb_param *param, uchar *key1, uchar *key2);
 static void init_block(HP_BLOCK *block,uint reclength,ulong min_records,
 		       ulong max_records);
 
@@ -25,7 +24,7 @@ static void init_block(HP_BLOCK *block,uint reclength,ulong min_records,
 int heap_create(const char *name, HP_CREATE_INFO *create_info,
                 HP_SHARE **res, my_bool *created_new_share)
 {
-  uint i, j, key_segs, max_length, length;
+  uint i, j, key_segs, max_length, length, null_parts;
   HP_SHARE *share= 0;
   HA_KEYSEG *keyseg;
   HP_KEYDEF *keydef= create_info->keydef;
@@ -66,8 +65,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     for (i= key_segs= max_length= 0, keyinfo= keydef; i < keys; i++, keyinfo++)
     {
       bzero((char*) &keyinfo->block,sizeof(keyinfo->block));
-      bzero((char*) &keyinfo->rb_tree ,sizeof(keyinfo->rb_tree));
-      for (j= length= 0; j < keyinfo->keysegs; j++)
+      bzero((char*) &keyinfo->btree, sizeof(keyinfo->btree));
+      for (j= length= null_parts= 0; j < keyinfo->keysegs; j++)
       {
 	length+= keyinfo->seg[j].length;
 	if (keyinfo->seg[j].null_bit)
@@ -76,7 +75,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 	  if (!(keyinfo->flag & HA_NULL_ARE_EQUAL))
 	    keyinfo->flag|= HA_NULL_PART_KEY;
 	  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
-	    keyinfo->rb_tree.size_of_element++;
+	    null_parts++;
 	}
 	switch (keyinfo->seg[j].type) {
 	case HA_KEYTYPE_SHORT_INT:
@@ -143,7 +142,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 	}
       }
       keyinfo->length= length;
-      length+= keyinfo->rb_tree.size_of_element + 
+      length+= null_parts +
 	       ((keyinfo->algorithm == HA_KEY_ALG_BTREE) ? sizeof(uchar*) : 0);
       if (length > max_length)
 	max_length= length;
@@ -151,6 +150,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
       if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
       {
         key_segs++; /* additional HA_KEYTYPE_END segment */
+        keyinfo->btree.key_length= length;
         if (keyinfo->flag & HA_VAR_LENGTH_KEY)
           keyinfo->get_key_length= hp_rb_var_key_length;
         else if (keyinfo->flag & HA_NULL_PART_KEY)
@@ -161,7 +161,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     }
     if (!(share= (HP_SHARE*) my_malloc((uint) sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+				       create_info->blobs*sizeof(HP_BLOB_DESC),
 				       MYF(MY_ZEROFILL |
                                            (create_info->internal_table ?
                                             MY_THREAD_SPECIFIC : 0)))))
@@ -169,6 +170,20 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     share->keydef= (HP_KEYDEF*) (share + 1);
     share->key_stat_version= 1;
     keyseg= (HA_KEYSEG*) (share->keydef + keys);
+    share->blob_descs= (HP_BLOB_DESC*) (keyseg + key_segs);
+    if ((share->blobs= create_info->blobs))
+    {
+      memcpy(share->blob_descs, create_info->blob_descs,
+             sizeof(HP_BLOB_DESC) * create_info->blobs);
+      /* Keep BLOB columns in record order, see hp_blob_rec_cmp() */
+      for (i= 1; i < share->blobs; i++)
+      {
+        HP_BLOB_DESC tmp= share->blob_descs[i];
+        for (j= i; j > 0 && share->blob_descs[j - 1].offset > tmp.offset; j--)
+          share->blob_descs[j]= share->blob_descs[j - 1];
+        share->blob_descs[j]= tmp;
+      }
+    }
     init_block(&share->block, visible_offset + 1, min_records, max_records);
 	/* Fix keys */
     memcpy(share->keydef, keydef, (size_t) (sizeof(keydef[0]) * keys));
@@ -188,10 +203,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 	keyseg->null_bit= 0;
 	keyseg++;
 
-	init_tree(&keyinfo->rb_tree, 0, 0, sizeof(uchar*),
-		  (qsort_cmp2)keys_compare, NULL, NULL,
-                  MYF((create_info->internal_table ? MY_THREAD_SPECIFIC : 0) |
-                      MY_TREE_WITH_DELETE));
+	hp_btree_init(&keyinfo->btree, keyinfo->btree.key_length,
+                      create_info->internal_table);
 	keyinfo->delete_key= hp_rb_delete_key;
 	keyinfo->write_key= hp_rb_write_key;
       }
@@ -256,13 +269,6 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 } /* heap_create */
 
 
-static int keys_compare(heap_rb_param *param, uchar *key1, uchar *key2)
-{
-  uint not_used[2];
-  return ha_key_cmp(param->keyseg, key1, key2, param->key_length, 
-		    param->search_flag, not_used);
-}
-
 static void init_block(HP_BLOCK *block, uint reclength, ulong min_records,
 		       ulong max_records)
 {
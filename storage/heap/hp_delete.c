@@ -42,6 +42,8 @@ int heap_delete(HP_INFO *info, const uchar *record)
       goto err;
   }
 
+  if (share->blobs)
+    hp_free_blobs(share, pos);
   info->update=HA_STATE_DELETED;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
@@ -61,26 +63,22 @@ int heap_delete(HP_INFO *info, const uchar *record)
 
 
 /*
-  Remove one key from rb-tree
+  Remove one key from BTREE index
 */
 
 int hp_rb_delete_key(HP_INFO *info, register HP_KEYDEF *keyinfo,
 		   const uchar *record, uchar *recpos, int flag)
 {
-  heap_rb_param custom_arg;
-  size_t old_allocated;
+  size_t old_allocated= keyinfo->btree.allocated;
+  uint key_length;
   int res;
 
   if (flag) 
-    info->last_pos= NULL; /* For heap_rnext/heap_rprev */
-
-  custom_arg.keyseg= keyinfo->seg;
-  custom_arg.key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
-  custom_arg.search_flag= SEARCH_SAME;
-  old_allocated= keyinfo->rb_tree.allocated;
-  res= tree_delete(&keyinfo->rb_tree, info->recbuf, custom_arg.key_length,
-                   &custom_arg);
-  info->s->index_length-= (old_allocated - keyinfo->rb_tree.allocated);
+    info->last_pos.leaf= NULL; /* For heap_rnext/heap_rprev */
+
+  key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
+  res= hp_btree_delete(keyinfo, info->recbuf, key_length);
+  info->s->index_length-= (old_allocated - keyinfo->btree.allocated);
   return res;
 }
 
@@ -19,6 +19,31 @@
 #include "heapdef.h"
 #include <m_ctype.h>
 
+/*
+  Number of keys before an end of a range: the keys < key for
+  HA_READ_KEY_EXACT and HA_READ_BEFORE_KEY, the keys <= key for
+  HA_READ_AFTER_KEY
+*/
+
+static ha_rows hp_rb_key_pos(HP_INFO *info, HP_KEYDEF *keyinfo,
+                             key_range *key)
+{
+  uint key_length= hp_rb_pack_key(keyinfo, info->recbuf, key->key,
+                                  key->keypart_map);
+  switch (key->flag) {
+  case HA_READ_KEY_EXACT:
+  case HA_READ_BEFORE_KEY:
+    return hp_btree_records_before(keyinfo, info->recbuf, key_length,
+                                   SEARCH_FIND | SEARCH_SAME, 0);
+  case HA_READ_AFTER_KEY:
+    return hp_btree_records_before(keyinfo, info->recbuf, key_length,
+                                   SEARCH_FIND | SEARCH_SAME, 1);
+  default:
+    return HA_POS_ERROR;
+  }
+}
+
+
 /*
   Find out how many rows there is in the given range
 
@@ -41,8 +66,7 @@
   RETURN
    HA_POS_ERROR		Something is wrong with the index tree.
    0			There is no matching keys in the given range
-   number > 0		There is approximately 'number' matching rows in
-			the range.
+   number > 0		There is 'number' matching rows in the range.
 */
 
 ha_rows hp_rb_records_in_range(HP_INFO *info, int inx,  key_range *min_key,
@@ -50,20 +74,12 @@ ha_rows hp_rb_records_in_range(HP_INFO *info, int inx,  key_range *min_key,
 {
   ha_rows start_pos, end_pos;
   HP_KEYDEF *keyinfo= info->s->keydef + inx;
-  TREE *rb_tree = &keyinfo->rb_tree;
-  heap_rb_param custom_arg;
   DBUG_ENTER("hp_rb_records_in_range");
 
   info->lastinx= inx;
-  custom_arg.keyseg= keyinfo->seg;
-  custom_arg.search_flag= SEARCH_FIND | SEARCH_SAME;
   if (min_key)
   {
-    custom_arg.key_length= hp_rb_pack_key(keyinfo, (uchar*) info->recbuf,
-					  (uchar*) min_key->key,
-					  min_key->keypart_map);
-    start_pos= tree_record_pos(rb_tree, info->recbuf, min_key->flag,
-			       &custom_arg);
+    start_pos= hp_rb_key_pos(info, keyinfo, min_key);
   }
   else
   {
@@ -72,15 +88,11 @@ ha_rows hp_rb_records_in_range(HP_INFO *info, int inx,  key_range *min_key,
 
   if (max_key)
   {
-    custom_arg.key_length= hp_rb_pack_key(keyinfo, (uchar*) info->recbuf,
-					  (uchar*) max_key->key,
-                                          max_key->keypart_map);
-    end_pos= tree_record_pos(rb_tree, info->recbuf, max_key->flag,
-			     &custom_arg);
+    end_pos= hp_rb_key_pos(info, keyinfo, max_key);
   }
   else
   {
-    end_pos= rb_tree->elements_in_tree + (ha_rows)1;
+    end_pos= keyinfo->btree.records;
   }
 
   DBUG_PRINT("info",("start_pos: %lu  end_pos: %lu", (ulong) start_pos,
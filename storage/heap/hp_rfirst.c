@@ -31,13 +31,14 @@ int heap_rfirst(HP_INFO *info, uchar *record, int inx)
   {
     uchar *pos;
 
-    if ((pos = tree_search_edge(&keyinfo->rb_tree, info->parents,
-                                &info->last_pos, offsetof(TREE_ELEMENT, left))))
+    if ((pos= hp_btree_first(keyinfo, &info->last_pos)))
     {
       memcpy(&pos, pos + (*keyinfo->get_key_length)(keyinfo, pos), 
 	     sizeof(uchar*));
       info->current_ptr = pos;
       memcpy(record, pos, (size_t)share->reclength);
+      if (share->blobs && hp_read_blobs(info, record))
+        DBUG_RETURN(my_errno);
       /*
         If we're performing index_first on a table that was taken from
         table cache, info->lastkey_len is initialized to previous query.
@@ -31,13 +31,14 @@ int heap_rlast(HP_INFO *info, uchar *record, int inx)
   {
     uchar *pos;
 
-    if ((pos = tree_search_edge(&keyinfo->rb_tree, info->parents,
-                                &info->last_pos, offsetof(TREE_ELEMENT, right))))
+    if ((pos= hp_btree_last(keyinfo, &info->last_pos)))
     {
       memcpy(&pos, pos + (*keyinfo->get_key_length)(keyinfo, pos), 
 	     sizeof(uchar*));
       info->current_ptr = pos;
       memcpy(record, pos, (size_t)share->reclength);
+      if (share->blobs && hp_read_blobs(info, record))
+        DBUG_RETURN(my_errno);
       info->update = HA_STATE_AKTIV;
     }
     else
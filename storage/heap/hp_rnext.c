@@ -31,8 +31,6 @@ int heap_rnext(HP_INFO *info, uchar *record)
   keyinfo = share->keydef + info->lastinx;
   if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
   {
-    heap_rb_param custom_arg;
-
     /* If no active record and last was not deleted */
     if (!(info->update & (HA_STATE_AKTIV | HA_STATE_NO_KEY |
                           HA_STATE_DELETED)))
@@ -42,20 +40,17 @@ int heap_rnext(HP_INFO *info, uchar *record)
       else
       {
         /* Last was 'prev' before first record; search after first record */
-        pos= tree_search_edge(&keyinfo->rb_tree, info->parents,
-                              &info->last_pos, offsetof(TREE_ELEMENT, left));
+        pos= hp_btree_first(keyinfo, &info->last_pos);
       }
     }
-    else if (info->last_pos)
+    else if (info->last_pos.leaf)
     {
       /*
         We enter this branch for non-DELETE queries after heap_rkey()
         or heap_rfirst(). As last key position (info->last_pos) is available,
-        we only need to climb the tree using tree_search_next().
+        we only need to move to the next key in the leaf.
       */
-      pos = tree_search_next(&keyinfo->rb_tree, &info->last_pos,
-                             offsetof(TREE_ELEMENT, left),
-                             offsetof(TREE_ELEMENT, right));
+      pos= hp_btree_next(keyinfo, &info->last_pos);
     }
     else if (!info->lastkey_len)
     {
@@ -67,11 +62,10 @@ int heap_rnext(HP_INFO *info, uchar *record)
 
         It should be safe to handle this situation without this branch. That is
         branch below should find smallest element in a tree as lastkey_len is
-        zero. tree_search_edge() is a kind of optimisation here as it should be
-        faster than tree_search_key().
+        zero. hp_btree_first() is a kind of optimisation here as it should be
+        faster than hp_btree_search().
       */
-      pos= tree_search_edge(&keyinfo->rb_tree, info->parents,
-                            &info->last_pos, offsetof(TREE_ELEMENT, left));
+      pos= hp_btree_first(keyinfo, &info->last_pos);
     }
     else
     {
@@ -81,12 +75,10 @@ int heap_rnext(HP_INFO *info, uchar *record)
         (last key is removed by heap_delete()), we must restart search as it
         is done in heap_rkey().
       */
-      custom_arg.keyseg = keyinfo->seg;
-      custom_arg.key_length = info->lastkey_len;
-      custom_arg.search_flag = SEARCH_SAME | SEARCH_FIND;
       info->last_find_flag= HA_READ_KEY_OR_NEXT;
-      pos = tree_search_key(&keyinfo->rb_tree, info->lastkey, info->parents, 
-                           &info->last_pos, info->last_find_flag, &custom_arg);
+      pos= hp_btree_search(keyinfo, &info->last_pos, info->lastkey,
+                           info->lastkey_len, SEARCH_SAME | SEARCH_FIND,
+                           info->last_find_flag);
     }
     if (pos)
     {
@@ -125,6 +117,8 @@ int heap_rnext(HP_INFO *info, uchar *record)
     DBUG_RETURN(my_errno);
   }
   memcpy(record,pos,(size_t) share->reclength);
+  if (share->blobs && hp_read_blobs(info, record))
+    DBUG_RETURN(my_errno);
   info->update=HA_STATE_AKTIV | HA_STATE_NEXT_FOUND;
   DBUG_RETURN(0);
 }
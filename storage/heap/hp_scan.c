@@ -70,6 +70,36 @@ int heap_scan(register HP_INFO *info, uchar *record)
   }
   info->update= HA_STATE_PREV_FOUND | HA_STATE_NEXT_FOUND | HA_STATE_AKTIV;
   memcpy(record,info->current_ptr,(size_t) share->reclength);
+  if (share->blobs && hp_read_blobs(info, record))
+    DBUG_RETURN(my_errno);
   info->current_hash_ptr=0;			/* Can't use read_next */
   DBUG_RETURN(0);
 } /* heap_scan */
+
+
+/*
+  Remember the current position of a table scan
+
+  NOTES
+    heap_scan_restart() continues the scan after the remembered row.
+*/
+
+void heap_scan_remember(HP_INFO *info)
+{
+  info->saved_ptr= info->current_ptr;
+  info->saved_record= info->current_record;
+  info->saved_next_block= info->next_block;
+}
+
+
+/*
+  Read the row remembered by heap_scan_remember() and continue the table
+  scan from it
+*/
+
+int heap_scan_restart(HP_INFO *info, uchar *record)
+{
+  info->current_record= info->saved_record;
+  info->next_block= info->saved_next_block;
+  return heap_rrnd(info, record, info->saved_ptr);
+}
@@ -0,0 +1,412 @@
+/* Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Test and benchmark of the B+tree used for BTREE keys of heap tables.
+
+  The same keys are stored in the B+tree and in a red-black tree of mysys,
+  that was used for BTREE keys before, and the results of lookups, range
+  scans and deletes are compared. The time used for each step is printed
+  for both trees.
+
+  Usage: hp_test_btree [-m#] [-d#] [-r#]
+    -m#   Number of keys (1000000)
+    -d#   Number of different key values (keys / 4)
+    -r#   Keys read by one range scan (100)
+*/
+
+#include "heapdef.h"
+#include <my_tree.h>
+#include <myisampack.h>
+
+typedef struct {
+  HA_KEYSEG *keyseg;
+  uint key_length;
+  uint search_flag;
+} rb_param;
+
+static ulong key_count= 1000000L, values= 0, range_length= 100;
+static ulong seed= 1;
+static int error_count= 0;
+
+static int get_options(int argc, char *argv[]);
+
+
+static int keys_compare(rb_param *param, uchar *key1, uchar *key2)
+{
+  uint not_used[2];
+  return ha_key_cmp(param->keyseg, key1, key2, param->key_length,
+                    param->search_flag, not_used);
+}
+
+
+static ulong rnd(ulong max_value)
+{
+  seed= seed * 1103515245 + 12345;
+  return (ulong) ((seed >> 8) % max_value);
+}
+
+
+static double timer_start()
+{
+  return (double) my_interval_timer();
+}
+
+
+static double timer_end(double start)
+{
+  return ((double) my_interval_timer() - start) / 1e9;
+}
+
+
+static void check(my_bool ok, const char *what, ulong nr)
+{
+  if (!ok && error_count++ < 10)
+    printf("error: %s differs at %lu\n", what, nr);
+}
+
+
+static void print_times(const char *step, double btree_time,
+                        double rb_time)
+{
+  printf("%-20s %10.3f %10.3f %8.2f\n", step, btree_time, rb_time,
+         btree_time > 0 ? rb_time / btree_time : 0.0);
+}
+
+
+/*
+  Make the image of a key, as stored in the trees. Every key gets a
+  different fake record pointer.
+*/
+
+static uint make_key(HP_KEYDEF *keyinfo, uchar *image, int32 value, ulong nr)
+{
+  uchar record[8];
+  bzero(record, sizeof(record));
+  int4store(record + 1, value);
+  return hp_rb_make_key(keyinfo, image, record,
+                        (uchar*) (size_t) ((nr + 1) * 8));
+}
+
+
+static uint pack_key(HP_KEYDEF *keyinfo, uchar *key, int32 value)
+{
+  uchar search_key[4];
+  int4store(search_key, value);
+  return hp_rb_pack_key(keyinfo, key, search_key, 1);
+}
+
+
+static my_bool same_key(const uchar *a, const uchar *b, uint image_length)
+{
+  if (!a || !b)
+    return a == b;
+  return !memcmp(a, b, image_length);
+}
+
+
+/* Number of keys < value, counted with a scan */
+
+static ulong count_before(HP_KEYDEF *keyinfo, HP_BTREE_POS *pos,
+                          int32 value)
+{
+  uchar *key;
+  ulong count= 0;
+  for (key= hp_btree_first(keyinfo, pos); key && mi_sint4korr(key) < value;
+       key= hp_btree_next(keyinfo, pos))
+    count++;
+  return count;
+}
+
+
+int main(int argc, char **argv)
+{
+  HP_CREATE_INFO hp_create_info;
+  HP_KEYDEF keydef, *keyinfo;
+  HA_KEYSEG keyseg;
+  HP_SHARE *share;
+  HP_BTREE_POS pos;
+  TREE rb_tree;
+  TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1], **last_pos;
+  rb_param param;
+  my_bool unused;
+  uchar *images, *image, *key, *btree_key, *rb_key;
+  uint image_length, image_key_length, key_length;
+  ulong i, j, found, *order;
+  double start, btree_time, rb_time;
+  MY_INIT(argv[0]);
+
+  get_options(argc, argv);
+  if (!values)
+    values= key_count / 4 + 1;
+
+  bzero(&hp_create_info, sizeof(hp_create_info));
+  bzero(&keydef, sizeof(keydef));
+  bzero(&keyseg, sizeof(keyseg));
+  hp_create_info.keys= 1;
+  hp_create_info.keydef= &keydef;
+  hp_create_info.reclength= 8;
+  hp_create_info.max_table_size= 1024L*1024L;
+  keydef.keysegs= 1;
+  keydef.seg= &keyseg;
+  keydef.algorithm= HA_KEY_ALG_BTREE;
+  keyseg.type= HA_KEYTYPE_LONG_INT;
+  keyseg.start= 1;
+  keyseg.length= 4;
+  keyseg.charset= &my_charset_latin1;
+
+  if (heap_create("test_btree", &hp_create_info, &share, &unused))
+  {
+    printf("error: Can't create heap table\n");
+    exit(1);
+  }
+  keyinfo= share->keydef;
+  image_length= keyinfo->btree.key_length;
+
+  param.keyseg= keyinfo->seg;
+  init_tree(&rb_tree, 0, 0, sizeof(uchar*), (qsort_cmp2) keys_compare,
+            NULL, NULL, MYF(MY_TREE_WITH_DELETE));
+
+  if (!(images= (uchar*) my_malloc(key_count * image_length, MYF(MY_WME))) ||
+      !(order= (ulong*) my_malloc(key_count * sizeof(ulong), MYF(MY_WME))) ||
+      !(pos.key= (uchar*) my_malloc(image_length, MYF(MY_WME))) ||
+      !(key= (uchar*) my_malloc(image_length, MYF(MY_WME))))
+    exit(1);
+
+  for (i= 0, image= images; i < key_count; i++, image+= image_length)
+    image_key_length= make_key(keyinfo, image, (int32) rnd(values), i);
+
+  printf("keys: %lu  different values: %lu  node size: %u  "
+         "keys in leaf: %u  keys in inner node: %u\n\n",
+         key_count, values, keyinfo->btree.node_size,
+         keyinfo->btree.leaf_keys, keyinfo->btree.node_keys);
+  printf("%-20s %10s %10s %8s\n", "seconds", "B+tree", "rb-tree", "ratio");
+
+  /* Insert */
+  start= timer_start();
+  for (i= 0, image= images; i < key_count; i++, image+= image_length)
+    check(!hp_btree_insert(keyinfo, image, image_key_length), "insert", i);
+  btree_time= timer_end(start);
+
+  param.key_length= image_key_length;
+  param.search_flag= SEARCH_SAME;
+  start= timer_start();
+  for (i= 0, image= images; i < key_count; i++, image+= image_length)
+    check(tree_insert(&rb_tree, image, image_key_length, &param) != 0,
+          "rb-tree insert", i);
+  rb_time= timer_end(start);
+  print_times("insert", btree_time, rb_time);
+
+  /* Point lookups */
+  param.search_flag= SEARCH_FIND | SEARCH_SAME;
+  for (i= 0; i < key_count; i++)
+    order[i]= rnd(values + values / 10);
+  start= timer_start();
+  for (i= found= 0; i < key_count; i++)
+  {
+    key_length= pack_key(keyinfo, key, (int32) order[i]);
+    if (hp_btree_search(keyinfo, &pos, key, key_length,
+                        SEARCH_FIND | SEARCH_SAME, HA_READ_KEY_EXACT))
+      found++;
+  }
+  btree_time= timer_end(start);
+  start= timer_start();
+  for (i= 0; i < key_count; i++)
+  {
+    param.key_length= pack_key(keyinfo, key, (int32) order[i]);
+    if (tree_search_key(&rb_tree, key, parents, &last_pos,
+                        HA_READ_KEY_EXACT, &param))
+      found--;
+  }
+  rb_time= timer_end(start);
+  check(found == 0, "lookup", 0);
+  print_times("lookup", btree_time, rb_time);
+
+  /* Range scans, forward and backward */
+  for (i= 0; i < key_count / range_length; i++)
+    order[i]= rnd(values);
+  start= timer_start();
+  for (i= found= 0; i < key_count / range_length; i++)
+  {
+    key_length= pack_key(keyinfo, key, (int32) order[i]);
+    for (j= 0, btree_key= hp_btree_search(keyinfo, &pos, key, key_length,
+                                          SEARCH_FIND | SEARCH_SAME,
+                                          HA_READ_KEY_OR_NEXT);
+         btree_key && j < range_length;
+         j++, btree_key= hp_btree_next(keyinfo, &pos))
+      found+= (ulong) mi_sint4korr(btree_key);
+  }
+  btree_time= timer_end(start);
+  start= timer_start();
+  for (i= 0; i < key_count / range_length; i++)
+  {
+    param.key_length= pack_key(keyinfo, key, (int32) order[i]);
+    for (j= 0, rb_key= tree_search_key(&rb_tree, key, parents, &last_pos,
+                                       HA_READ_KEY_OR_NEXT, &param);
+         rb_key && j < range_length;
+         j++, rb_key= tree_search_next(&rb_tree, &last_pos,
+                                       offsetof(TREE_ELEMENT, left),
+                                       offsetof(TREE_ELEMENT, right)))
+      found-= (ulong) mi_sint4korr(rb_key);
+  }
+  rb_time= timer_end(start);
+  check(found == 0, "range scan", 0);
+  print_times("range scan", btree_time, rb_time);
+
+  for (i= 0; i < key_count / range_length; i++)
+  {
+    key_length= pack_key(keyinfo, key, (int32) order[i]);
+    param.key_length= key_length;
+    btree_key= hp_btree_search(keyinfo, &pos, key, key_length,
+                               SEARCH_FIND | SEARCH_SAME,
+                               HA_READ_BEFORE_KEY);
+    rb_key= tree_search_key(&rb_tree, key, parents, &last_pos,
+                            HA_READ_BEFORE_KEY, &param);
+    for (j= 0; j < range_length; j++)
+    {
+      check(same_key(btree_key, rb_key, image_length), "backward scan", i);
+      if (!btree_key || !rb_key)
+        break;
+      btree_key= hp_btree_prev(keyinfo, &pos);
+      rb_key= tree_search_next(&rb_tree, &last_pos,
+                               offsetof(TREE_ELEMENT, right),
+                               offsetof(TREE_ELEMENT, left));
+    }
+  }
+
+  /* Other search functions */
+  for (i= 0; i < 1000; i++)
+  {
+    static const enum ha_rkey_function flags[]=
+    {
+      HA_READ_KEY_EXACT, HA_READ_KEY_OR_NEXT, HA_READ_KEY_OR_PREV,
+      HA_READ_AFTER_KEY, HA_READ_BEFORE_KEY, HA_READ_PREFIX_LAST,
+      HA_READ_PREFIX_LAST_OR_PREV
+    };
+    int32 value= (int32) rnd(values + 2) - 1;
+    key_length= pack_key(keyinfo, key, value);
+    param.key_length= key_length;
+    for (j= 0; j < array_elements(flags); j++)
+    {
+      btree_key= hp_btree_search(keyinfo, &pos, key, key_length,
+                                 SEARCH_FIND | SEARCH_SAME, flags[j]);
+      rb_key= tree_search_key(&rb_tree, key, parents, &last_pos, flags[j],
+                              &param);
+      check(same_key(btree_key, rb_key, image_length), "search", i);
+    }
+  }
+
+  /* Positions for records_in_range() */
+  for (i= 0; i < 5; i++)
+  {
+    int32 value= (int32) rnd(values);
+    key_length= pack_key(keyinfo, key, value);
+    check(hp_btree_records_before(keyinfo, key, key_length,
+                                  SEARCH_FIND | SEARCH_SAME, 0) ==
+          count_before(keyinfo, &pos, value), "records before", i);
+  }
+
+  /* Delete every second key, then the rest */
+  for (j= 0; j < 2; j++)
+  {
+    start= timer_start();
+    for (i= j, image= images + j * image_length; i < key_count;
+         i+= 2, image+= 2 * image_length)
+      check(!hp_btree_delete(keyinfo, image, image_key_length), "delete", i);
+    btree_time= timer_end(start);
+    param.key_length= image_key_length;
+    param.search_flag= SEARCH_SAME;
+    start= timer_start();
+    for (i= j, image= images + j * image_length; i < key_count;
+         i+= 2, image+= 2 * image_length)
+      check(!tree_delete(&rb_tree, image, image_key_length, &param),
+            "rb-tree delete", i);
+    rb_time= timer_end(start);
+    print_times("delete", btree_time, rb_time);
+
+    check(keyinfo->btree.records == rb_tree.elements_in_tree, "records", j);
+    btree_key= hp_btree_first(keyinfo, &pos);
+    rb_key= tree_search_edge(&rb_tree, parents, &last_pos,
+                             offsetof(TREE_ELEMENT, left));
+    for (i= 0; btree_key || rb_key; i++)
+    {
+      check(same_key(btree_key, rb_key, image_length), "scan", i);
+      if (!btree_key || !rb_key)
+        break;
+      btree_key= hp_btree_next(keyinfo, &pos);
+      rb_key= tree_search_next(&rb_tree, &last_pos,
+                               offsetof(TREE_ELEMENT, left),
+                               offsetof(TREE_ELEMENT, right));
+    }
+  }
+  check(!keyinfo->btree.root, "empty tree", 0);
+
+  /* Unique key */
+  keyinfo->flag|= HA_NOSAME;
+  key_length= make_key(keyinfo, key, 1, 0);
+  check(!hp_btree_insert(keyinfo, key, key_length), "unique", 0);
+  key_length= make_key(keyinfo, key, 1, 1);
+  check(hp_btree_insert(keyinfo, key, key_length) == HA_ERR_FOUND_DUPP_KEY,
+        "unique", 1);
+  hp_btree_free(&keyinfo->btree);
+  check(keyinfo->btree.allocated == 0, "free", 0);
+
+  delete_tree(&rb_tree, 0);
+  my_free(images);
+  my_free(order);
+  my_free(pos.key);
+  my_free(key);
+  heap_delete_table("test_btree");
+
+  if (error_count)
+    printf("\n%d errors\n", error_count);
+  else
+    printf("\nok\n");
+  my_end(MY_CHECK_ERROR);
+  return error_count ? 1 : 0;
+}
+
+
+static int get_options(int argc, char **argv)
+{
+  char *pos, *progname= argv[0];
+
+  while (--argc > 0 && *(pos= *(++argv)) == '-')
+  {
+    switch (*++pos) {
+    case 'm':
+      key_count= (ulong) atol(++pos);
+      break;
+    case 'd':
+      values= (ulong) atol(++pos);
+      break;
+    case 'r':
+      range_length= (ulong) atol(++pos);
+      break;
+    case '#':
+      DBUG_PUSH(++pos);
+      break;
+    default:
+      printf("Usage: %s [-m#] [-d#] [-r#]\n", progname);
+      exit(0);
+    }
+  }
+  if (!key_count || !range_length)
+  {
+    printf("Usage: %s [-m#] [-d#] [-r#]\n", progname);
+    exit(0);
+  }
+  return 0;
+}
@@ -31,6 +31,8 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
 
   if (info->opt_flag & READ_CHECK_USED && hp_rectest(info,old))
     DBUG_RETURN(my_errno);				/* Record changed */
+  if (share->blobs && hp_prepare_blob_update(info, old, heap_new))
+    DBUG_RETURN(my_errno);
   if (--(share->records) < share->blength >> 1) share->blength>>= 1;
   share->changed=1;
 
@@ -47,7 +49,10 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
     }
   }
 
-  memcpy(pos,heap_new,(size_t) share->reclength);
+  if (share->blobs)
+    hp_finish_blob_update(info, pos, heap_new);
+  else
+    memcpy(pos,heap_new,(size_t) share->reclength);
   if (++(share->records) == share->blength) share->blength+= share->blength;
 
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
@@ -65,11 +70,13 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
     info->errkey = (int) (keydef - share->keydef);
     if (keydef->algorithm == HA_KEY_ALG_BTREE)
     {
-      /* we don't need to delete non-inserted key from rb-tree */
+      /* we don't need to delete non-inserted key from BTREE index */
       if ((*keydef->write_key)(info, keydef, old, pos))
       {
         if (++(share->records) == share->blength)
 	  share->blength+= share->blength;
+        if (share->blobs)
+          hp_abort_blob_update(info, heap_new);
         DBUG_RETURN(my_errno);
       }
       keydef--;
@@ -87,5 +94,7 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
   }
   if (++(share->records) == share->blength)
     share->blength+= share->blength;
+  if (share->blobs)
+    hp_abort_blob_update(info, heap_new);
   DBUG_RETURN(my_errno);
 } /* heap_update */
@@ -46,6 +46,10 @@ int heap_write(HP_INFO *info, const uchar *record)
     DBUG_RETURN(my_errno);
   share->changed=1;
 
+  memcpy(pos,record,(size_t) share->reclength);
+  if (share->blobs && hp_write_blobs(share, pos))
+    goto err_blobs;
+
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
        keydef++)
   {
@@ -53,7 +57,6 @@ int heap_write(HP_INFO *info, const uchar *record)
       goto err;
   }
 
-  memcpy(pos,record,(size_t) share->reclength);
   pos[share->visible]= 1;                     /* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
@@ -73,7 +76,7 @@ int heap_write(HP_INFO *info, const uchar *record)
     DBUG_PRINT("info",("Duplicate key: %d", (int) (keydef - share->keydef)));
   info->errkey= (int) (keydef - share->keydef);
   /*
-    We don't need to delete non-inserted key from rb-tree.  Also, if
+    We don't need to delete non-inserted key from BTREE index.  Also, if
     we got ENOMEM, the key wasn't inserted, so don't try to delete it
     either.  Otherwise for HASH index on HA_ERR_FOUND_DUPP_KEY the key
     was inserted and we have to delete it.
@@ -88,7 +91,10 @@ int heap_write(HP_INFO *info, const uchar *record)
       break;
     keydef--;
   } 
+  if (share->blobs)
+    hp_free_blobs(share, pos);
 
+err_blobs:
   share->deleted++;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
@@ -98,35 +104,22 @@ int heap_write(HP_INFO *info, const uchar *record)
 } /* heap_write */
 
 /* 
-  Write a key to rb_tree-index 
+  Write a key to BTREE index
 */
 
 int hp_rb_write_key(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *record, 
 		    uchar *recpos)
 {
-  heap_rb_param custom_arg;
-  size_t old_allocated;
+  size_t old_allocated= keyinfo->btree.allocated;
+  uint key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
+  int error;
 
-  custom_arg.keyseg= keyinfo->seg;
-  custom_arg.key_length= hp_rb_make_key(keyinfo, info->recbuf, record, recpos);
-  if (keyinfo->flag & HA_NOSAME)
-  {
-    custom_arg.search_flag= SEARCH_FIND | SEARCH_UPDATE | SEARCH_INSERT;
-    keyinfo->rb_tree.flag= TREE_NO_DUPS;
-  }
-  else
-  {
-    custom_arg.search_flag= SEARCH_SAME;
-    keyinfo->rb_tree.flag= 0;
-  }
-  old_allocated= keyinfo->rb_tree.allocated;
-  if (!tree_insert(&keyinfo->rb_tree, (void*)info->recbuf,
-		   custom_arg.key_length, &custom_arg))
+  if ((error= hp_btree_insert(keyinfo, info->recbuf, key_length)))
   {
-    my_errno= HA_ERR_FOUND_DUPP_KEY;
+    my_errno= error;
     return 1;
   }
-  info->s->index_length+= (keyinfo->rb_tree.allocated-old_allocated);
+  info->s->index_length+= (keyinfo->btree.allocated - old_allocated);
   return 0;
 }
 
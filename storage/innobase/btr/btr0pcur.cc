@@ -429,6 +429,107 @@ btr_pcur_restore_position_func(
 	return(FALSE);
 }
 
+/** Try to position a persistent cursor with a search on the leaf page
+where its position was stored the last time, instead of a search from the
+root of the index tree. This succeeds when the page has not been freed or
+reorganized since then and the search tuple falls inside the key range
+of the records on the page, which is the common case when the lookups are
+made with keys in ascending order.
+@param[in]	index	index of the stored position
+@param[in]	tuple	search tuple
+@param[in,out]	cursor	persistent cursor
+@param[in,out]	mtr	mini-transaction
+@return whether the cursor was positioned with the search mode PAGE_CUR_GE
+and the latch mode BTR_SEARCH_LEAF; if not, no latches were acquired */
+bool
+btr_pcur_open_on_stored_leaf(
+	dict_index_t*	index,
+	const dtuple_t*	tuple,
+	btr_pcur_t*	cursor,
+	mtr_t*		mtr)
+{
+	btr_cur_t*	btr_cursor = btr_pcur_get_btr_cur(cursor);
+	ulint		latch_mode = BTR_SEARCH_LEAF;
+
+	if (!cursor->old_stored
+	    || cursor->rel_pos == BTR_PCUR_AFTER_LAST_IN_TREE
+	    || cursor->rel_pos == BTR_PCUR_BEFORE_FIRST_IN_TREE
+	    || btr_cur_get_index(btr_cursor) != index
+	    || dict_index_is_spatial(index)
+	    || buf_pool_is_obsolete(cursor->withdraw_clock)) {
+		return(false);
+	}
+
+	buf_block_t*	block = cursor->block_when_stored;
+	ulint		savepoint = mtr_set_savepoint(mtr);
+
+	if (!btr_cur_optimistic_latch_leaves(block, cursor->modify_clock,
+					     &latch_mode, btr_cursor,
+					     __FILE__, __LINE__, mtr)) {
+		return(false);
+	}
+
+	const page_t*	page = buf_block_get_frame(block);
+	mem_heap_t*	heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	const rec_t*	rec;
+	bool		inside = page_is_leaf(page)
+		&& !page_is_empty(page)
+		&& btr_page_get_index_id(page) == index->id;
+
+	rec_offs_init(offsets_);
+
+	/* The position of the first record not less than the tuple may be
+	on the previous page unless the tuple is greater than the first
+	record, and on the next page if the tuple is greater than the last
+	record. */
+
+	if (inside && page_has_prev(page)) {
+		rec = page_rec_get_next_const(page_get_infimum_rec(page));
+		offsets = rec_get_offsets(rec, index, offsets, true,
+					  dtuple_get_n_fields(tuple), &heap);
+		inside = cmp_dtuple_rec(tuple, rec, offsets) > 0;
+	}
+
+	if (inside && page_has_next(page)) {
+		rec = page_rec_get_prev_const(page_get_supremum_rec(page));
+		offsets = rec_get_offsets(rec, index, offsets, true,
+					  dtuple_get_n_fields(tuple), &heap);
+		inside = cmp_dtuple_rec(tuple, rec, offsets) <= 0;
+	}
+
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
+
+	if (!inside) {
+		mtr->release_block_at_savepoint(savepoint, block);
+		return(false);
+	}
+
+	ulint	up_match = 0;
+	ulint	low_match = 0;
+
+	page_cur_search_with_match(block, index, tuple, PAGE_CUR_GE,
+				   &up_match, &low_match,
+				   btr_pcur_get_page_cur(cursor), NULL);
+
+	btr_cursor->flag = BTR_CUR_BINARY;
+	btr_cursor->up_match = up_match;
+	btr_cursor->up_bytes = 0;
+	btr_cursor->low_match = low_match;
+	btr_cursor->low_bytes = 0;
+
+	cursor->latch_mode = BTR_SEARCH_LEAF;
+	cursor->search_mode = PAGE_CUR_GE;
+	cursor->pos_state = BTR_PCUR_IS_POSITIONED;
+	cursor->old_stored = false;
+	cursor->trx_if_known = NULL;
+
+	return(true);
+}
+
 /*********************************************************//**
 Moves the persistent cursor to the first record on the next page. Releases the
 latch on the current page, and bufferunfixes it. Note that there must not be
@@ -9403,6 +9403,7 @@ ha_innobase::change_active_index(
 	active_index = keynr;
 
 	m_prebuilt->index = innobase_get_index(keynr);
+	m_prebuilt->keys_in_order = 0;
 
 	if (m_prebuilt->index == NULL) {
 		sql_print_warning("InnoDB: change_active_index(%u) failed",
@@ -15239,6 +15240,9 @@ ha_innobase::extra(
 		trx_register_for_2pc(m_prebuilt->trx);
 		m_prebuilt->sql_stat_start = true;
 		break;
+	case HA_EXTRA_SORTED_KEY_LOOKUPS:
+		m_prebuilt->keys_in_order = 1;
+		break;
 	default:/* Do nothing */
 		;
 	}
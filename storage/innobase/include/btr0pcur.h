@@ -277,6 +277,22 @@ btr_pcur_restore_position_func(
 	mtr_t*		mtr);		/*!< in: mtr */
 #define btr_pcur_restore_position(l,cur,mtr)				\
 	btr_pcur_restore_position_func(l,cur,__FILE__,__LINE__,mtr)
+/** Try to position a persistent cursor with a search on the leaf page
+where its position was stored the last time, instead of a search from the
+root of the index tree.
+@param[in]	index	index of the stored position
+@param[in]	tuple	search tuple
+@param[in,out]	cursor	persistent cursor
+@param[in,out]	mtr	mini-transaction
+@return whether the cursor was positioned with the search mode PAGE_CUR_GE
+and the latch mode BTR_SEARCH_LEAF; if not, no latches were acquired */
+bool
+btr_pcur_open_on_stored_leaf(
+	dict_index_t*	index,
+	const dtuple_t*	tuple,
+	btr_pcur_t*	cursor,
+	mtr_t*		mtr)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
 /*********************************************************//**
 Gets the rel_pos field for a cursor whose position has been stored.
 @return BTR_PCUR_ON, ... */
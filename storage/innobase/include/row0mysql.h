@@ -617,6 +617,14 @@ struct row_prebuilt_t {
 					unique search from a clustered index,
 					because HANDLER allows NEXT and PREV
 					in such a situation */
+	unsigned	keys_in_order:1;/*!< TRUE if MySQL has told with
+					HA_EXTRA_SORTED_KEY_LOOKUPS that the
+					following index lookups of the scan
+					are made with keys in ascending order:
+					then we store the pcur position even
+					in a unique search from a clustered
+					index, and try to do the next search
+					on the same leaf page */
 	unsigned	template_type:2;/*!< ROW_MYSQL_WHOLE_ROW,
 					ROW_MYSQL_REC_FIELDS,
 					ROW_MYSQL_DUMMY_TEMPLATE, or
@@ -4327,6 +4327,7 @@ row_search_mvcc(
 	    && dict_index_is_clust(index)
 	    && !prebuilt->templ_contains_blob
 	    && !prebuilt->used_in_HANDLER
+	    && !prebuilt->keys_in_order
 	    && (prebuilt->mysql_row_len < srv_page_size / 8)) {
 
 		mode = PAGE_CUR_GE;
@@ -4566,9 +4567,19 @@ row_search_mvcc(
 			}
 		}
 
-		err = btr_pcur_open_with_no_init(index, search_tuple, mode,
-					   	 BTR_SEARCH_LEAF,
-					   	 pcur, 0, &mtr);
+		if (prebuilt->keys_in_order
+		    && mode == PAGE_CUR_GE
+		    && btr_pcur_open_on_stored_leaf(index, search_tuple,
+						    pcur, &mtr)) {
+			/* The lookups are made in ascending key order
+			and the key is on the leaf page of the previous
+			lookup: we did not need to search the tree. */
+			err = DB_SUCCESS;
+		} else {
+			err = btr_pcur_open_with_no_init(
+				index, search_tuple, mode, BTR_SEARCH_LEAF,
+				pcur, 0, &mtr);
+		}
 
 		if (err != DB_SUCCESS) {
 			rec = NULL;
@@ -5466,7 +5477,8 @@ row_search_mvcc(
 	store the pcur position, because any fetch next or prev will anyway
 	return 'end of file'. Exceptions are locking reads and the MySQL
 	HANDLER command where the user can move the cursor with PREV or NEXT
-	even after a unique search. */
+	even after a unique search, and lookups in ascending key order where
+	the next search can start from the stored position. */
 
 	err = DB_SUCCESS;
 
@@ -5475,7 +5487,8 @@ row_search_mvcc(
 	    || !dict_index_is_clust(index)
 	    || direction != 0
 	    || prebuilt->select_lock_type != LOCK_NONE
-	    || prebuilt->used_in_HANDLER) {
+	    || prebuilt->used_in_HANDLER
+	    || prebuilt->keys_in_order) {
 
 		/* Inside an update always store the cursor position */
 
@@ -203,9 +203,8 @@ find_or_create_digest(PFS_thread *thread,
   */
   PFS_digest_key hash_key;
   memset(& hash_key, 0, sizeof(hash_key));
-  /* Compute MD5 Hash of the tokens received. */
-  compute_digest_md5(digest_storage, hash_key.m_md5);
-  memcpy((void*)& digest_storage->m_md5, &hash_key.m_md5, MD5_HASH_SIZE);
+  /* Compute Hash of the tokens received. */
+  hash_key.m_hash= compute_digest_hash(digest_storage);
   /* Add the current schema to the key */
   hash_key.m_schema_name_length= schema_name_length;
   if (schema_name_length > 0)
@@ -276,6 +275,8 @@ find_or_create_digest(PFS_thread *thread,
           used later to generate digest text.
         */
         pfs->m_digest_storage.copy(digest_storage);
+        /* MD5 Hash to be shown as DIGEST, computed once per record. */
+        compute_digest_md5(&pfs->m_digest_storage, pfs->m_digest_storage.m_md5);
 
         pfs->m_first_seen= now;
         pfs->m_last_seen= now;
@@ -331,9 +331,10 @@ void table_events_statements_common::make_row_part_2(const sql_digest_storage *d
   if (safe_byte_count > 0 &&
       safe_byte_count <= pfs_max_digest_length)
   {
-    /* Generate the DIGEST string from the MD5 digest  */
-    MD5_HASH_TO_STRING(digest->m_md5,
-                       m_row.m_digest.m_digest);
+    /* Generate the DIGEST string from the MD5 digest of the token array */
+    unsigned char md5[MD5_HASH_SIZE];
+    compute_digest_md5(digest, md5);
+    MD5_HASH_TO_STRING(md5, m_row.m_digest.m_digest);
     m_row.m_digest.m_digest_length= MD5_HASH_TO_STRING_LENGTH;
 
     /* Generate the DIGEST_TEXT string from the token array */
@@ -0,0 +1,180 @@
+/*
+   Copyright (c) 2019, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  Unit test and microbenchmark for the metadata lock fast path:
+  many threads acquiring and releasing SR/SW locks on the same table,
+  as done by concurrent point lookups and updates.
+*/
+
+#include <tap.h>
+#include <sql_class.h>
+
+static const int THREADS= 4;
+static const int ITERATIONS= 100000;
+
+/** Owner of a context which never waits for a lock. */
+class Test_owner : public MDL_context_owner
+{
+public:
+  virtual void enter_cond(mysql_cond_t *cond, mysql_mutex_t *mutex,
+                          const PSI_stage_info *stage,
+                          PSI_stage_info *old_stage,
+                          const char *src_function, const char *src_file,
+                          int src_line)
+  {}
+  virtual void exit_cond(const PSI_stage_info *stage,
+                         const char *src_function, const char *src_file,
+                         int src_line)
+  {}
+  virtual int is_killed() { return 0; }
+  virtual THD* get_thd() { return NULL; }
+  virtual bool notify_shared_lock(MDL_context_owner *in_use,
+                                  bool needs_thr_lock_abort)
+  { return false; }
+};
+
+
+struct Worker
+{
+  pthread_t thread;
+  enum_mdl_type type;
+  int failures;
+};
+
+
+static void *worker_thread(void *arg)
+{
+  Worker *worker= (Worker*) arg;
+  Test_owner owner;
+  MDL_context ctx;
+  MDL_request request;
+
+  my_thread_init();
+  ctx.init(&owner);
+  for (int i= 0; i < ITERATIONS; i++)
+  {
+    request.init(MDL_key::TABLE, "test", "t1", worker->type, MDL_TRANSACTION);
+    if (ctx.try_acquire_lock(&request) || !request.ticket)
+      worker->failures++;
+    ctx.release_transactional_locks();
+  }
+  ctx.destroy();
+  my_thread_end();
+  return NULL;
+}
+
+
+static void run_benchmark(const char *name, enum_mdl_type type_a,
+                          enum_mdl_type type_b)
+{
+  Worker workers[THREADS];
+  int failures= 0;
+  ulonglong start= my_interval_timer();
+
+  for (int i= 0; i < THREADS; i++)
+  {
+    workers[i].type= i % 2 ? type_b : type_a;
+    workers[i].failures= 0;
+    pthread_create(&workers[i].thread, NULL, worker_thread, &workers[i]);
+  }
+  for (int i= 0; i < THREADS; i++)
+  {
+    pthread_join(workers[i].thread, NULL);
+    failures+= workers[i].failures;
+  }
+
+  ulonglong ns= my_interval_timer() - start;
+  diag("%s: %d threads, %llu ns per lock/unlock", name, THREADS,
+       ns / (THREADS * (ulonglong) ITERATIONS));
+  ok(failures == 0, "%s: all locks granted", name);
+}
+
+
+static bool try_lock(MDL_context *ctx, MDL_request *request,
+                     enum_mdl_type type)
+{
+  request->init(MDL_key::TABLE, "test", "t1", type, MDL_TRANSACTION);
+  return !ctx->try_acquire_lock(request) && request->ticket;
+}
+
+
+#ifndef WITH_WSREP
+/**
+  Check that locks acquired on the fast path still conflict with
+  obtrusive locks in both directions.
+*/
+
+static void test_conflicts()
+{
+  Test_owner owner_a, owner_b;
+  MDL_context ctx_a, ctx_b;
+  MDL_request request_a, request_b;
+
+  ctx_a.init(&owner_a);
+  ctx_b.init(&owner_b);
+
+  ok(try_lock(&ctx_b, &request_b, MDL_SHARED_READ), "SR granted");
+  ok(!try_lock(&ctx_a, &request_a, MDL_EXCLUSIVE),
+     "X conflicts with SR acquired on the fast path");
+  ok(!try_lock(&ctx_a, &request_a, MDL_SHARED_NO_READ_WRITE),
+     "SNRW conflicts with SR acquired on the fast path");
+  ok(try_lock(&ctx_a, &request_a, MDL_SHARED_NO_WRITE),
+     "SNW is compatible with SR acquired on the fast path");
+  ok(!try_lock(&ctx_b, &request_b, MDL_SHARED_WRITE),
+     "SW conflicts with SNW");
+  ok(try_lock(&ctx_b, &request_b, MDL_SHARED_READ), "SR still granted");
+  ctx_a.release_transactional_locks();
+  ok(try_lock(&ctx_b, &request_b, MDL_SHARED_WRITE),
+     "SW granted after SNW is released");
+  ctx_b.release_transactional_locks();
+
+  ok(try_lock(&ctx_a, &request_a, MDL_EXCLUSIVE),
+     "X granted after SR is released");
+  ok(!try_lock(&ctx_b, &request_b, MDL_SHARED_READ), "SR conflicts with X");
+  ctx_a.release_transactional_locks();
+
+  ok(try_lock(&ctx_a, &request_a, MDL_SHARED_WRITE) &&
+     try_lock(&ctx_a, &request_a, MDL_EXCLUSIVE),
+     "X granted while holding SW in the same context");
+  ctx_a.release_transactional_locks();
+
+  ctx_a.destroy();
+  ctx_b.destroy();
+}
+#endif
+
+
+int main(int argc __attribute__((unused)), char **argv)
+{
+  MY_INIT(argv[0]);
+  plan(12);
+  mdl_init();
+
+  run_benchmark("SR", MDL_SHARED_READ, MDL_SHARED_READ);
+  run_benchmark("SR+SW", MDL_SHARED_READ, MDL_SHARED_WRITE);
+#ifdef WITH_WSREP
+  /* can_grant_lock() needs a THD in wsrep builds. */
+  skip(10, "conflict checks need a THD with WITH_WSREP");
+#else
+  test_conflicts();
+#endif
+
+  mdl_destroy();
+  my_end(0);
+  return exit_status();
+}